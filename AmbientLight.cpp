@@ -0,0 +1,106 @@
+#include "AmbientLight.hpp"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+namespace // anonymous namespace
+{
+
+// The filtered level keeps 5 fractional bits - 1023 << 5 still fits into 15 bits.
+uint8_t constexpr fractionBits = 5;
+// Exponential moving average over 2^filterShift samples [about .5 s].
+uint8_t constexpr filterShift = 8;
+
+volatile uint16_t filteredLevelScaled = 0;
+
+uint16_t constexpr stepWidth = (AmbientLight::maximumLevel + 1) / AmbientLight::Dimmer::stepCount;
+uint16_t constexpr hysteresis = 16;
+
+// Roughly perceptually even steps from dark to bright.
+uint8_t const stepFactors[AmbientLight::Dimmer::stepCount] PROGMEM = {16, 24, 40, 64, 96, 140, 196, 255};
+
+uint16_t levelFromConversion()
+{
+    // The resistor divider gives lower voltages for brighter light.
+    return AmbientLight::maximumLevel - ADC;
+}
+
+} // anonymous namespace
+
+ISR(ADC_vect)
+{
+    uint16_t const sampleScaled = levelFromConversion() << fractionBits;
+    // Rounded - the arithmetic shift alone floors, which kept the level up to 8 below the samples.
+    // Shifting by one less first keeps the + 1 from overflowing 16 bits.
+    int16_t const differenceScaled = static_cast<int16_t>(sampleScaled - filteredLevelScaled);
+    filteredLevelScaled += ((differenceScaled >> (filterShift - 1)) + 1) >> 1;
+}
+
+namespace AmbientLight
+{
+
+void initialize()
+{
+    DIDR0 |= _BV(ADC1D);
+    ADMUX = _BV(REFS0) | _BV(MUX0);                         // AVCC reference, ADC1
+    ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0); // F_CPU / 128: 62.5 kHz ADC clock
+
+    // Only at startup - the first conversion takes 25 ADC clocks [400 us].
+    ADCSRA |= _BV(ADSC);
+    while (ADCSRA & _BV(ADSC))
+    {
+        // intentionally empty
+    }
+    filteredLevelScaled = levelFromConversion() << fractionBits;
+
+    // A conversion starts on each rising edge of TOV0 - Timer0's ISR clears the flag in between.
+    ADCSRB = _BV(ADTS2);                                    // auto trigger on Timer0 overflow
+    ADCSRA |= _BV(ADATE) | _BV(ADIF) | _BV(ADIE);
+}
+
+uint16_t level()
+{
+    uint16_t value = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = filteredLevelScaled;
+    }
+    return value >> fractionBits;
+}
+
+bool Dimmer::update(uint16_t const level)
+{
+    uint8_t const candidate = level / stepWidth;
+    bool const brighter = (candidate > step) && (level >= candidate * stepWidth + hysteresis);
+    bool const darker = (candidate < step) && (level + hysteresis < step * stepWidth);
+    if (brighter || darker)
+    {
+        step = candidate;
+        return true;
+    }
+    return false;
+}
+
+uint8_t Dimmer::factor() const
+{
+    return pgm_read_byte(&stepFactors[step]);
+}
+
+void scale(Adafruit_NeoPixel & strip, uint8_t const bytesPerPixel, uint8_t const factor)
+{
+    if (255 == factor)
+    {
+        return;
+    }
+
+    uint16_t const byteCount = strip.numPixels() * bytesPerPixel;
+    uint8_t * const pixels = strip.getPixels();
+    for (uint16_t i = 0; i < byteCount; ++i)
+    {
+        pixels[i] = (static_cast<uint16_t>(pixels[i]) * (static_cast<uint16_t>(factor) + 1)) >> 8;
+    }
+}
+
+} // namespace AmbientLight
@@ -0,0 +1,50 @@
+#ifndef AMBIENTLIGHT_HPP
+#define AMBIENTLIGHT_HPP
+
+#include <Adafruit_NeoPixel.h>
+
+#include <stdint.h>
+
+/**
+ * Ambient light from a light dependent resistor [between ADC1 - PC1, A1 - and GND, a 10 kOhm resistor
+ * to VCC: brighter is lower]. The ADC converts in the background, auto-triggered by each Timer0 overflow
+ * [every 2.048 ms at 8 MHz - the millis() timer], and its ISR low-pass filters the samples in fixed point.
+ * So the loop never waits for a conversion, it only reads the filtered level.
+ */
+namespace AmbientLight
+{
+
+// Filtered level in [0, maximumLevel] - 0 is darkest.
+uint16_t constexpr maximumLevel = 1023;
+
+// Seeds the filter with one conversion, then starts the background conversions.
+void initialize();
+
+uint16_t level();
+
+/**
+ * @brief The Dimmer class Global brightness factor in steps of the ambient level. The step only
+ * changes once the level left the step's range by a hysteresis margin, so a level close to a step
+ * boundary does not make the ring flicker between two brightnesses.
+ */
+class Dimmer
+{
+public:
+    static uint8_t constexpr stepCount = 8;
+
+    // Returns true if the factor changed.
+    bool update(uint16_t const level);
+
+    // Brightness factor in 1/256 [255 is unchanged].
+    uint8_t factor() const;
+
+private:
+    uint8_t step = stepCount - 1;
+};
+
+// Scale all channels of the frame in strip - on top of the brightness of the hands.
+void scale(Adafruit_NeoPixel & strip, uint8_t const bytesPerPixel, uint8_t const factor);
+
+} // namespace AmbientLight
+
+#endif // AMBIENTLIGHT_HPP
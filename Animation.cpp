@@ -0,0 +1,80 @@
+#include "Animation.hpp"
+
+namespace // anonymous namespace
+{
+
+// Stretch [0, 255] to [0, 256], so that multiplications can be normalized by shifting.
+inline uint16_t toUnit256(uint8_t const value)
+{
+    return static_cast<uint16_t>(value) + (value >> 7);
+}
+
+// Clip [0, 256] back to [0, 255].
+inline uint8_t fromUnit256(uint16_t const value)
+{
+    return (255 < value) ? 255 : static_cast<uint8_t>(value);
+}
+
+inline uint8_t easeInQuadratic(uint8_t const progress)
+{
+    uint32_t const x = toUnit256(progress);
+    return fromUnit256((x * x) >> 8);
+}
+
+} // anonymous namespace
+
+namespace Animation
+{
+
+uint8_t ease(Easing const easing, uint8_t const progress)
+{
+    uint8_t eased = progress;
+    switch (easing)
+    {
+    case Easing::linear:
+    {
+        break;
+    }
+    case Easing::easeIn:
+    {
+        eased = easeInQuadratic(progress);
+        break;
+    }
+    case Easing::easeOut:
+    {
+        eased = 255 - easeInQuadratic(255 - progress);
+        break;
+    }
+    case Easing::easeInOut:
+    {
+        // smoothstep: x^2 * (3 - 2x)
+        uint32_t const x = toUnit256(progress);
+        eased = fromUnit256((x * x * (768 - 2 * x)) >> 16);
+        break;
+    }
+    }
+    return eased;
+}
+
+void Tween::start(unsigned long const now, uint16_t const durationMs, Easing const easing)
+{
+    startTime = now;
+    duration = durationMs;
+    easingCurve = easing;
+    active = true;
+}
+
+uint8_t Tween::progress(unsigned long const now)
+{
+    unsigned long const elapsed = now - startTime;
+    if (!active || (duration <= elapsed))
+    {
+        active = false;
+        return 255;
+    }
+    // elapsed < duration <= 0xffff, hence this fits and yields [0, 255].
+    uint8_t const linear = static_cast<uint8_t>((static_cast<uint32_t>(elapsed) << 8) / duration);
+    return ease(easingCurve, linear);
+}
+
+} // namespace Animation
@@ -0,0 +1,185 @@
+#ifndef ANIMATION_HPP
+#define ANIMATION_HPP
+
+#include <Adafruit_NeoPixel.h>
+
+#include "Colors.hpp"
+
+namespace Animation
+{
+
+/**
+ * Easing curves operate on a progress in [0, 255] and return an eased progress in [0, 255].
+ * All curves map 0 -> 0 and 255 -> 255 and only use integer math.
+ */
+enum class Easing : uint8_t
+{
+    linear,
+    easeIn,     // quadratic
+    easeOut,    // quadratic
+    easeInOut   // smoothstep
+};
+
+uint8_t ease(Easing const easing, uint8_t const progress);
+
+/**
+ * @brief The Tween class Time based progress from 0 to 255 over durationMs.
+ * Finishes itself once durationMs have elapsed.
+ */
+class Tween
+{
+public:
+    void start(unsigned long const now, uint16_t const durationMs, Easing const easing);
+
+    void stop()
+    {
+        active = false;
+    }
+
+    bool isActive() const
+    {
+        return active;
+    }
+
+    // Eased progress in [0, 255]. Returns 255 [and deactivates] once durationMs have elapsed.
+    uint8_t progress(unsigned long const now);
+
+private:
+    unsigned long startTime = 0;
+    uint16_t duration = 0;
+    Easing easingCurve = Easing::linear;
+    bool active = false;
+};
+
+/**
+ * @brief The Crossfade class Blends from a captured frame to the currently composed frame.
+ * start() captures what is currently in the strip [i.e. the last frame shown], apply()
+ * blends the freshly composed frame in the strip with the captured one. Hence apply() has
+ * to be called after composing and before strip.show().
+ */
+template<uint16_t pixelCount>
+class Crossfade
+{
+public:
+    void start(Adafruit_NeoPixel const & strip, unsigned long const now, uint16_t const durationMs, Easing const easing = Easing::easeInOut)
+    {
+        for (uint16_t i = 0; i < pixelCount; ++i)
+        {
+            from[i] = strip.getPixelColor(i);
+        }
+        tween.start(now, durationMs, easing);
+    }
+
+    void apply(Adafruit_NeoPixel & strip, unsigned long const now)
+    {
+        if (tween.isActive())
+        {
+            uint8_t const alpha = tween.progress(now);
+            for (uint16_t i = 0; i < pixelCount; ++i)
+            {
+                strip.setPixelColor(i, Colors::blendColors(from[i], strip.getPixelColor(i), alpha));
+            }
+        }
+    }
+
+    void stop()
+    {
+        tween.stop();
+    }
+
+    bool isActive() const
+    {
+        return tween.isActive();
+    }
+
+private:
+    Colors::Color_t from[pixelCount];
+    Tween tween;
+};
+
+/**
+ * @brief The Trail class Afterglow of a moving hand - a persistent intensity per pixel, which decays
+ * exponentially with the elapsed time and is refreshed at the hand's pixel. A decay step multiplies by
+ * 1 - 2^-decayShift. The steps due since the last update are folded into one factor, so that an update
+ * is a single pass over the buffer and the decay does not depend on the frame rate.
+ */
+template<uint16_t pixelCount>
+class Trail
+{
+public:
+    static uint8_t constexpr decayShift = 3;
+
+    void clear()
+    {
+        for (uint16_t i = 0; i < pixelCount; ++i)
+        {
+            intensities[i] = 0;
+        }
+        pendingMs = 0;
+        visible = false;
+    }
+
+    // Decay by the time since the last update in steps of stepMs [> 0], then deposit the hand at headPixel.
+    void update(unsigned long const now, uint16_t const headPixel, uint16_t const stepMs)
+    {
+        unsigned long const dueMs = pendingMs + (now - lastUpdateTime);
+        lastUpdateTime = now;
+        unsigned long steps = dueMs / stepMs;
+        pendingMs = dueMs % stepMs;
+
+        if (0 < steps)
+        {
+            // In 1/65536 - below 256 all intensities vanish.
+            uint16_t factor = UINT16_MAX;
+            for (; (0 < steps) && (256 <= factor); --steps)
+            {
+                factor -= factor >> decayShift;
+            }
+            uint16_t const factor256 = (256 <= factor) ? ((factor >> 8) + 1) : 0;
+
+            visible = false;
+            for (uint16_t i = 0; i < pixelCount; ++i)
+            {
+                intensities[i] = (static_cast<uint16_t>(intensities[i]) * factor256) >> 8;
+                visible = visible || (0 != intensities[i]);
+            }
+        }
+
+        intensities[headPixel] = 255;
+        visible = true;
+    }
+
+    // Time [ms] until the next decay step changes the trail - UINT16_MAX if nothing is left to decay.
+    uint16_t millisUntilDecay(uint16_t const stepMs) const
+    {
+        return visible ? static_cast<uint16_t>(stepMs - pendingMs) : UINT16_MAX;
+    }
+
+    // Add the trail in color to the ring starting at the strip's firstPixel. The hands are added as well,
+    // so adding the trail after them equals compositing it under them.
+    void addTo(Adafruit_NeoPixel & strip, uint16_t const firstPixel, Colors::Color_t const color) const
+    {
+        if (!visible)
+        {
+            return;
+        }
+        for (uint16_t i = 0; i < pixelCount; ++i)
+        {
+            if (0 != intensities[i])
+            {
+                uint16_t const stripPixel = firstPixel + i;
+                strip.setPixelColor(stripPixel, Colors::addColors(strip.getPixelColor(stripPixel), Colors::colorScale(color, intensities[i])));
+            }
+        }
+    }
+
+private:
+    uint8_t intensities[pixelCount] = {};
+    unsigned long lastUpdateTime = 0;
+    uint16_t pendingMs = 0;
+    bool visible = false;
+};
+
+} // namespace Animation
+
+#endif // ANIMATION_HPP
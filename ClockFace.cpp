@@ -0,0 +1,243 @@
+#include "ClockFace.hpp"
+
+#include "Footprints.hpp"
+#include "RingArithmetic.hpp"
+
+#include <avr/pgmspace.h>
+
+namespace // anonymous namespace
+{
+
+// max(f(x)) of each selectable kernel.
+constexpr float selectableKernelMaximumDensities[ClockFace::selectableKernelCount] PROGMEM = {
+    NeoPixelPatterns::KernelDelta().maximumDensity(),
+    NeoPixelPatterns::KernelMountain(.1).maximumDensity(),
+    NeoPixelPatterns::KernelMountain(.2).maximumDensity(),
+    NeoPixelPatterns::KernelGaussian(.35).maximumDensity(),
+    NeoPixelPatterns::KernelGaussian(.7).maximumDensity(),
+    NeoPixelPatterns::KernelTriangle(.35).maximumDensity(),
+    NeoPixelPatterns::KernelTriangle(.7).maximumDensity(),
+    NeoPixelPatterns::KernelCosine(.35).maximumDensity(),
+    NeoPixelPatterns::KernelCosine(.7).maximumDensity(),
+};
+
+// Footprints of the selectable kernels - the radii are the smallest for which the taps left out are below 1 LSB.
+constexpr Footprints::Table<1> footprintDelta PROGMEM = Footprints::generate<1>(NeoPixelPatterns::KernelDelta());
+constexpr Footprints::Table<3> footprintMountainNarrow PROGMEM = Footprints::generate<3>(NeoPixelPatterns::KernelMountain(.1));
+constexpr Footprints::Table<4> footprintMountainWide PROGMEM = Footprints::generate<4>(NeoPixelPatterns::KernelMountain(.2));
+constexpr Footprints::Table<1> footprintGaussianNarrow PROGMEM = Footprints::generate<1>(NeoPixelPatterns::KernelGaussian(.35));
+constexpr Footprints::Table<2> footprintGaussianWide PROGMEM = Footprints::generate<2>(NeoPixelPatterns::KernelGaussian(.7));
+constexpr Footprints::Table<1> footprintTriangleNarrow PROGMEM = Footprints::generate<1>(NeoPixelPatterns::KernelTriangle(.35));
+constexpr Footprints::Table<2> footprintTriangleWide PROGMEM = Footprints::generate<2>(NeoPixelPatterns::KernelTriangle(.7));
+constexpr Footprints::Table<1> footprintCosineNarrow PROGMEM = Footprints::generate<1>(NeoPixelPatterns::KernelCosine(.35));
+constexpr Footprints::Table<2> footprintCosineWide PROGMEM = Footprints::generate<2>(NeoPixelPatterns::KernelCosine(.7));
+
+// Against the exact weights: .5 LSB from quantizing, the rest from interpolating between phases.
+double constexpr maximumFootprintErrorLsb = 1.25;
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintDelta, NeoPixelPatterns::KernelDelta()));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintMountainNarrow, NeoPixelPatterns::KernelMountain(.1)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintMountainWide, NeoPixelPatterns::KernelMountain(.2)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintGaussianNarrow, NeoPixelPatterns::KernelGaussian(.35)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintGaussianWide, NeoPixelPatterns::KernelGaussian(.7)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintTriangleNarrow, NeoPixelPatterns::KernelTriangle(.35)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintTriangleWide, NeoPixelPatterns::KernelTriangle(.7)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintCosineNarrow, NeoPixelPatterns::KernelCosine(.35)));
+static_assert(maximumFootprintErrorLsb >= Footprints::maximumError(footprintCosineWide, NeoPixelPatterns::KernelCosine(.7)));
+
+// 1419 bytes of flash for all nine.
+static_assert(1419 == sizeof(footprintDelta) + sizeof(footprintMountainNarrow) + sizeof(footprintMountainWide)
+              + sizeof(footprintGaussianNarrow) + sizeof(footprintGaussianWide)
+              + sizeof(footprintTriangleNarrow) + sizeof(footprintTriangleWide)
+              + sizeof(footprintCosineNarrow) + sizeof(footprintCosineWide));
+
+} // anonymous namespace
+
+
+namespace ClockFace
+{
+
+HueSaturation nextPaletteColor(HueSaturation const color)
+{
+    if (0 == color.saturation)
+    {
+        return HueSaturation(0, 255);
+    }
+    else if ((256 - paletteHueStep) <= color.hue)
+    {
+        return HueSaturation(0, 0);
+    }
+    return HueSaturation(color.hue + paletteHueStep, 255);
+}
+
+HueSaturation previousPaletteColor(HueSaturation const color)
+{
+    if (0 == color.saturation)
+    {
+        return HueSaturation(256 - paletteHueStep, 255);
+    }
+    else if (paletteHueStep > color.hue)
+    {
+        return HueSaturation(0, 0);
+    }
+    return HueSaturation(color.hue - paletteHueStep, 255);
+}
+
+uint8_t hueDistance(uint8_t const one, uint8_t const two)
+{
+    uint8_t const distance = one - two;
+    return (0x80 & distance) ? static_cast<uint8_t>(-distance) : distance;
+}
+
+bool colorsConflict(HueSaturation const one, HueSaturation const two)
+{
+    if ((0 == one.saturation) || (0 == two.saturation))
+    {
+        return (one.saturation == two.saturation);
+    }
+    return (minimumHueDistance > hueDistance(one.hue, two.hue));
+}
+
+SelectableKernel nextSelectableKernel(SelectableKernel const selectableKernel)
+{
+    return static_cast<SelectableKernel>((static_cast<uint8_t>(selectableKernel) + 1) % selectableKernelCount);
+}
+
+SelectableKernel previousSelectableKernel(SelectableKernel const selectableKernel)
+{
+    return static_cast<SelectableKernel>((static_cast<uint8_t>(selectableKernel) + selectableKernelCount - 1) % selectableKernelCount);
+}
+
+double SelectableKernelMaximumDensity::operator()(SelectableKernel const selectableKernel) const
+{
+    return pgm_read_float(&selectableKernelMaximumDensities[static_cast<uint8_t>(selectableKernel)]);
+}
+
+Footprints::Footprint SelectableKernelFootprint::operator()(SelectableKernel const selectableKernel) const
+{
+    switch (selectableKernel)
+    {
+    case SelectableKernel::delta:
+    {
+        return Footprints::footprintOf(footprintDelta, NeoPixelPatterns::KernelDelta());
+    }
+    case SelectableKernel::mountainNarrow:
+    {
+        return Footprints::footprintOf(footprintMountainNarrow, NeoPixelPatterns::KernelMountain(.1));
+    }
+    case SelectableKernel::mountainWide:
+    {
+        return Footprints::footprintOf(footprintMountainWide, NeoPixelPatterns::KernelMountain(.2));
+    }
+    case SelectableKernel::gaussianNarrow:
+    {
+        return Footprints::footprintOf(footprintGaussianNarrow, NeoPixelPatterns::KernelGaussian(.35));
+    }
+    case SelectableKernel::gaussianWide:
+    {
+        return Footprints::footprintOf(footprintGaussianWide, NeoPixelPatterns::KernelGaussian(.7));
+    }
+    case SelectableKernel::triangleNarrow:
+    {
+        return Footprints::footprintOf(footprintTriangleNarrow, NeoPixelPatterns::KernelTriangle(.35));
+    }
+    case SelectableKernel::triangleWide:
+    {
+        return Footprints::footprintOf(footprintTriangleWide, NeoPixelPatterns::KernelTriangle(.7));
+    }
+    case SelectableKernel::cosineNarrow:
+    {
+        return Footprints::footprintOf(footprintCosineNarrow, NeoPixelPatterns::KernelCosine(.35));
+    }
+    case SelectableKernel::cosineWide:
+    default:
+    {
+        return Footprints::footprintOf(footprintCosineWide, NeoPixelPatterns::KernelCosine(.7));
+    }
+    }
+}
+
+void clockHandsFromTimeOfDay(ClockHand (&hands)[clockHandCount],
+                             uint16_t const pixelCount,
+                             TimeOfDay const & timeOfDay,
+                             double const subseconds,
+                             ColorsSettings const & colorsSettings)
+{
+    double const secondsAndSubseconds = static_cast<double>(timeOfDay.seconds) + subseconds;
+
+    // The hours hand stays on a pixel - with the delta kernel this lights exactly that one.
+    uint16_t const pixelIndexHours = RingArithmetic::Ring<12>::normalize(timeOfDay.hours) * pixelCount / 12;
+    double const pixelIndexMinutes = (static_cast<double>(timeOfDay.minutes) + (secondsAndSubseconds / 60.)) / 60. * pixelCount;
+    double const pixelIndexSeconds = secondsAndSubseconds / 60. * pixelCount;
+
+    DisplayComponent const components[clockHandCount] = {DisplayComponent::hours, DisplayComponent::minutes, DisplayComponent::seconds};
+    double const positions[clockHandCount] = {static_cast<double>(pixelIndexHours), pixelIndexMinutes, pixelIndexSeconds};
+    for (uint8_t i = 0; i < clockHandCount; ++i)
+    {
+        hands[i].position = positions[i];
+        hands[i].kernel = colorsSettings.at(components[i]).selectableKernel;
+        hands[i].color = colorsSettings.at(components[i]).scaledColor();
+    }
+}
+
+void composeTimeOfDay(Adafruit_NeoPixel & strip, RingLayout const & ringLayout, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
+{
+    for (uint8_t r = 0; r < ringLayout.ringCount; ++r)
+    {
+        RingGeometry const & ring = ringLayout.rings[r];
+        ClockHand hands[clockHandCount];
+        clockHandsFromTimeOfDay(hands, ring.pixelCount, timeOfDay, subseconds, colorsSettings);
+        uint8_t handMask = 0;
+        for (uint8_t h = 0; h < clockHandCount; ++h)
+        {
+            if (r == ringLayout.handRings[h])
+            {
+                handMask |= 1 << h;
+            }
+        }
+        // Writes every pixel of the ring - no clear() needed.
+        Footprints::renderRing(strip, ring.firstPixel, ring.pixelCount, hands, SelectableKernelFootprint(), handMask);
+    }
+}
+
+void composeTimeOfDay(Adafruit_NeoPixel & strip, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
+{
+    composeTimeOfDay(strip, singleRingLayout(strip.numPixels()), timeOfDay, subseconds, colorsSettings);
+}
+
+void composeTimeOfDayAnalytic(Adafruit_NeoPixel & strip, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
+{
+    ClockHand hands[clockHandCount];
+    clockHandsFromTimeOfDay(hands, strip.numPixels(), timeOfDay, subseconds, colorsSettings);
+    NeoPixelPatterns::renderHands(strip, hands, SelectableKernelEvaluator());
+}
+
+double millisUntilTimeOfDayChanges(uint16_t const pixelCount, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
+{
+    return millisUntilTimeOfDayChanges(singleRingLayout(pixelCount), timeOfDay, subseconds, colorsSettings);
+}
+
+double millisUntilTimeOfDayChanges(RingLayout const & ringLayout, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
+{
+    double const secondsOfHour = static_cast<double>(timeOfDay.minutes) * 60. + static_cast<double>(timeOfDay.seconds) + subseconds;
+    double millisUntilChange = (3600. - secondsOfHour) * 1000.;
+
+    for (uint8_t r = 0; r < ringLayout.ringCount; ++r)
+    {
+        uint16_t const pixelCount = ringLayout.rings[r].pixelCount;
+        ClockHand hands[clockHandCount];
+        clockHandsFromTimeOfDay(hands, pixelCount, timeOfDay, subseconds, colorsSettings);
+
+        // [pixels per ms] of the hands on this ring - the hours hand steps once per hour instead.
+        double const velocities[clockHandCount] = {
+            0.,
+            (r == ringLayout.handRings[1]) ? (pixelCount / 3600000.) : 0.,
+            (r == ringLayout.handRings[2]) ? (pixelCount / 60000.) : 0.
+        };
+        double const millisUntilMotion = NeoPixelPatterns::millisUntilVisibleChange(hands, velocities, SelectableKernelMaximumDensity());
+        millisUntilChange = (millisUntilMotion < millisUntilChange) ? millisUntilMotion : millisUntilChange;
+    }
+
+    return millisUntilChange;
+}
+
+} // namespace ClockFace
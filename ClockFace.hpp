@@ -0,0 +1,288 @@
+#ifndef CLOCKFACE_HPP
+#define CLOCKFACE_HPP
+
+#include <Adafruit_NeoPixel.h>
+
+#include "Colors.hpp"
+#include "Footprints.hpp"
+#include "NeoPixelPatterns.hpp"
+
+/**
+ * What the clock shows: the settings of the hands and the rendering of a time of day.
+ * Free of the Arduino core besides Adafruit_NeoPixel's pixel buffer, so that host tools
+ * [see tools/dayrender] render exactly the same frames as the firmware.
+ */
+namespace ClockFace
+{
+
+// Color of a hand - saturation 0 is white.
+struct HueSaturation
+{
+    uint8_t hue = 0;
+    uint8_t saturation = 0;
+
+    constexpr HueSaturation(uint8_t const hue = 0, uint8_t const saturation = 0)
+        : hue(hue)
+        , saturation(saturation)
+    {
+        // intentionally empty
+    }
+};
+
+// The palette steps through 32 fully saturated hues, followed by white.
+uint8_t constexpr paletteHueStep = 8;
+// Saturated colors closer on the color circle than this are hard to tell apart on the ring.
+uint8_t constexpr minimumHueDistance = 24;
+
+HueSaturation nextPaletteColor(HueSaturation const color);
+
+HueSaturation previousPaletteColor(HueSaturation const color);
+
+// Shortest distance on the color circle [wraps at 256].
+uint8_t hueDistance(uint8_t const one, uint8_t const two);
+
+bool colorsConflict(HueSaturation const one, HueSaturation const two);
+
+
+// Brightness kernel and its width per hand.
+enum class SelectableKernel : uint8_t
+{
+    delta,
+    mountainNarrow,
+    mountainWide,
+    gaussianNarrow,
+    gaussianWide,
+    triangleNarrow,
+    triangleWide,
+    cosineNarrow,
+    cosineWide
+};
+
+uint8_t constexpr selectableKernelCount = static_cast<uint8_t>(SelectableKernel::cosineWide) + 1;
+
+SelectableKernel nextSelectableKernel(SelectableKernel const selectableKernel);
+
+SelectableKernel previousSelectableKernel(SelectableKernel const selectableKernel);
+
+// F(x) of the selected kernel - for NeoPixelPatterns::renderHands().
+struct SelectableKernelEvaluator
+{
+    double operator()(SelectableKernel const selectableKernel, double const x) const
+    {
+        double brightness = 0.;
+        switch (selectableKernel)
+        {
+        case SelectableKernel::delta:
+        {
+            brightness = NeoPixelPatterns::KernelDelta()(x);
+            break;
+        }
+        case SelectableKernel::mountainNarrow:
+        {
+            brightness = NeoPixelPatterns::KernelMountain(.1)(x);
+            break;
+        }
+        case SelectableKernel::mountainWide:
+        {
+            brightness = NeoPixelPatterns::KernelMountain(.2)(x);
+            break;
+        }
+        case SelectableKernel::gaussianNarrow:
+        {
+            brightness = NeoPixelPatterns::KernelGaussian(.35)(x);
+            break;
+        }
+        case SelectableKernel::gaussianWide:
+        {
+            brightness = NeoPixelPatterns::KernelGaussian(.7)(x);
+            break;
+        }
+        case SelectableKernel::triangleNarrow:
+        {
+            brightness = NeoPixelPatterns::KernelTriangle(.35)(x);
+            break;
+        }
+        case SelectableKernel::triangleWide:
+        {
+            brightness = NeoPixelPatterns::KernelTriangle(.7)(x);
+            break;
+        }
+        case SelectableKernel::cosineNarrow:
+        {
+            brightness = NeoPixelPatterns::KernelCosine(.35)(x);
+            break;
+        }
+        case SelectableKernel::cosineWide:
+        {
+            brightness = NeoPixelPatterns::KernelCosine(.7)(x);
+            break;
+        }
+        }
+        return brightness;
+    }
+};
+
+// max(f(x)) of the selected kernel [0 for steps] - for NeoPixelPatterns::millisUntilVisibleChange().
+struct SelectableKernelMaximumDensity
+{
+    double operator()(SelectableKernel const selectableKernel) const;
+};
+
+// Footprint of the selected kernel [tables in flash] - for Footprints::renderHands().
+struct SelectableKernelFootprint
+{
+    Footprints::Footprint operator()(SelectableKernel const selectableKernel) const;
+};
+
+
+// Values index the tables below.
+enum class DisplayComponent : uint8_t
+{
+    hours,
+    minutes,
+    seconds
+};
+
+uint8_t constexpr displayComponentCount = static_cast<uint8_t>(DisplayComponent::seconds) + 1;
+
+struct ColorSettings
+{
+    HueSaturation hueSaturation;
+    uint8_t brightness = 255;
+    SelectableKernel selectableKernel = SelectableKernel::mountainNarrow;
+
+    Colors::Color_t scaledColor() const
+    {
+        return Colors::colorFromHsv(hueSaturation.hue, hueSaturation.saturation, brightness);
+    }
+};
+
+struct ColorsSettings
+{
+    ColorSettings colorsSettings[displayComponentCount];
+
+    ColorSettings & at(DisplayComponent const component)
+    {
+        return colorsSettings[static_cast<uint8_t>(component)];
+    }
+
+    ColorSettings const & at(DisplayComponent const component) const
+    {
+        return colorsSettings[static_cast<uint8_t>(component)];
+    }
+
+    // Whether color is too close to the color of any other component.
+    bool colorConflicts(DisplayComponent const component, HueSaturation const color) const
+    {
+        for (uint8_t i = 0; i < displayComponentCount; ++i)
+        {
+            if ((static_cast<uint8_t>(component) != i) && colorsConflict(color, colorsSettings[i].hueSaturation))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Afterglow of the seconds hand [see Animation::Trail] - length 0 turns it off.
+struct TrailSettings
+{
+    HueSaturation hueSaturation{0, 255};
+    uint8_t length = 0;
+
+    // Duration of a decay step - the trail fades to half within about 5.2 steps.
+    uint16_t stepMs() const
+    {
+        return static_cast<uint16_t>(length) * 64;
+    }
+
+    Colors::Color_t scaledColor(uint8_t const brightness) const
+    {
+        return Colors::colorFromHsv(hueSaturation.hue, hueSaturation.saturation, brightness);
+    }
+};
+
+uint8_t constexpr maximumTrailLength = 15;
+
+
+
+struct TimeOfDay
+{
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+
+    TimeOfDay(uint8_t const hours = 0,
+              uint8_t const minutes = 0,
+              uint8_t const seconds = 0)
+        : hours(hours)
+        , minutes(minutes)
+        , seconds(seconds)
+    {
+        // intentinoally empty
+    }
+    TimeOfDay(const TimeOfDay &) = default;
+    TimeOfDay(TimeOfDay &&) = default;
+    TimeOfDay &operator=(const TimeOfDay &) = default;
+    TimeOfDay &operator=(TimeOfDay &&) = default;
+};
+
+
+typedef NeoPixelPatterns::Hand<SelectableKernel> ClockHand;
+uint8_t constexpr clockHandCount = 3;
+
+
+// A ring occupying the strip's pixels [firstPixel, firstPixel + pixelCount) - its pixel 0 at 12 o'clock, clockwise.
+struct RingGeometry
+{
+    uint16_t firstPixel;
+    uint16_t pixelCount;
+};
+
+uint8_t constexpr maximumRingCount = 2;
+
+// The rings chained in the strip and the ring of each hand [hours, minutes, seconds - indices into rings].
+struct RingLayout
+{
+    RingGeometry rings[maximumRingCount];
+    uint8_t ringCount;
+    uint8_t handRings[clockHandCount];
+
+    constexpr uint16_t pixelCount() const
+    {
+        return rings[ringCount - 1].firstPixel + rings[ringCount - 1].pixelCount;
+    }
+};
+
+constexpr RingLayout singleRingLayout(uint16_t const pixelCount)
+{
+    return RingLayout{{{0, pixelCount}, {pixelCount, 0}}, 1, {0, 0, 0}};
+}
+
+// The hands showing the time of day - hours, minutes and seconds.
+void clockHandsFromTimeOfDay(ClockHand (&hands)[clockHandCount],
+                             uint16_t const pixelCount,
+                             TimeOfDay const & timeOfDay,
+                             double const subseconds,
+                             ColorsSettings const & colorsSettings);
+
+// Compose the time of day into strip from the precomputed kernel footprints - strip.show() is left to the caller.
+// Each hand is rendered on its ring only.
+void composeTimeOfDay(Adafruit_NeoPixel & strip, RingLayout const & ringLayout, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings);
+
+// All hands on a single ring of all of strip's pixels.
+void composeTimeOfDay(Adafruit_NeoPixel & strip, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings);
+
+// Same from the analytic kernels - the reference for the footprints [see tools/dayrender].
+void composeTimeOfDayAnalytic(Adafruit_NeoPixel & strip, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings);
+
+// Time [ms] for which composeTimeOfDay() changes by less than 1 LSB per channel [before truncation].
+double millisUntilTimeOfDayChanges(uint16_t const pixelCount, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings);
+
+// The same for the hands on their rings.
+double millisUntilTimeOfDayChanges(RingLayout const & ringLayout, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings);
+
+} // namespace ClockFace
+
+#endif // CLOCKFACE_HPP
@@ -0,0 +1,77 @@
+#include "ClockScaling.hpp"
+
+#include <Arduino.h>
+
+#include <avr/io.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+
+namespace // anonymous namespace
+{
+
+// F_CPU / 8 and Timer0 at prescaler 8 instead of 64 - the timer's clock stays F_CPU / 64.
+uint8_t constexpr timer0ClockSelectMask = _BV(CS02) | _BV(CS01) | _BV(CS00);
+uint8_t constexpr timer0ClockSelectFull = _BV(CS01) | _BV(CS00);
+uint8_t constexpr timer0ClockSelectSlow = _BV(CS01);
+// ADPS n divides by 2^n - dividing by 8 less.
+uint8_t constexpr adcPrescalerMask = _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+uint8_t constexpr adcPrescalerStepsSlow = 3;
+
+unsigned long slowMillis = 0;
+unsigned long countStartTime = 0;
+
+void adjustAdcPrescaler(bool const slow)
+{
+    if (!(ADCSRA & _BV(ADEN)))
+    {
+        return;
+    }
+    uint8_t const prescaler = ADCSRA & adcPrescalerMask;
+    uint8_t const adjusted = slow ? ((adcPrescalerStepsSlow < prescaler) ? (prescaler - adcPrescalerStepsSlow) : 1)
+                                  : ((adcPrescalerMask - adcPrescalerStepsSlow >= prescaler) ? (prescaler + adcPrescalerStepsSlow) : adcPrescalerMask);
+    // Writing ADIF as 1 would clear a pending conversion result.
+    ADCSRA = (ADCSRA & ~(adcPrescalerMask | _BV(ADIF))) | adjusted;
+}
+
+void setSlowClock(bool const slow)
+{
+    // A tick of Timer0 may get lost or doubled at the switch [8 us] - far below what millis() resolves.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        clock_prescale_set(slow ? clock_div_8 : clock_div_1);
+        TCCR0B = (TCCR0B & ~timer0ClockSelectMask) | (slow ? timer0ClockSelectSlow : timer0ClockSelectFull);
+        adjustAdcPrescaler(slow);
+    }
+}
+
+} // anonymous namespace
+
+namespace ClockScaling
+{
+
+void idle(uint16_t const durationMs)
+{
+    unsigned long const start = millis();
+
+    setSlowClock(true);
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    while (static_cast<uint16_t>(millis() - start) < durationMs)
+    {
+        // Woken up by Timer0's overflow ISR at the latest.
+        sleep_mode();
+    }
+    setSlowClock(false);
+
+    slowMillis += millis() - start;
+}
+
+DutyCycle takeDutyCycle(unsigned long const now)
+{
+    DutyCycle const dutyCycle{slowMillis, now - countStartTime};
+    slowMillis = 0;
+    countStartTime = now;
+    return dutyCycle;
+}
+
+} // namespace ClockScaling
@@ -0,0 +1,30 @@
+#ifndef CLOCKSCALING_HPP
+#define CLOCKSCALING_HPP
+
+#include <stdint.h>
+
+/**
+ * Idles between loop() cycles at F_CPU / 8 in the idle sleep mode instead of busy waiting in delay().
+ * Timer0's prescaler is lowered by the same factor [64 -> 8] while the clock is reduced, so its tick
+ * stays at 8 us and millis() and micros() - and with them the button timing - keep running at their
+ * rate. An enabled ADC's prescaler is lowered likewise, its conversions keep their clock.
+ * Everything else clocked from the CPU clock [USART, TWI, Timer2] must be quiet while idling.
+ */
+namespace ClockScaling
+{
+
+// Returns after durationMs at the earliest and Timer0's overflow period [2.048 ms] at the latest after that.
+void idle(uint16_t const durationMs);
+
+// Time spent idling at the reduced clock and in total since the previous call - to estimate the energy saved.
+struct DutyCycle
+{
+    unsigned long slowMs;
+    unsigned long totalMs;
+};
+
+DutyCycle takeDutyCycle(unsigned long const now);
+
+} // namespace ClockScaling
+
+#endif // CLOCKSCALING_HPP
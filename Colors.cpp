@@ -33,6 +33,18 @@ inline uint8_t addColorPart(uint8_t const one, uint8_t const two)
 	}
 }
 
+inline uint8_t blendColorPart(uint8_t const one, uint8_t const two, uint16_t const alpha256)
+{
+    // alpha256 in [0, 256] - the sum is at most 255 * 256 and thus fits into 16 bits.
+    return (static_cast<uint16_t>(one) * (256 - alpha256) + static_cast<uint16_t>(two) * alpha256) >> 8;
+}
+
+inline uint8_t scale8(uint8_t const input, uint8_t const factor)
+{
+    // input * (factor + 1) / 256 - exact for factor 0 and 255.
+    return (static_cast<uint16_t>(input) * (static_cast<uint16_t>(factor) + 1)) >> 8;
+}
+
 } // anonymous namespace
 
 namespace Colors
@@ -46,6 +58,14 @@ Color_t colorScaleBrightness(Color_t const & input, double const & scaleFactor)
                          scaleColorPart(input >> 24, scaleFactor));
 }
 
+Color_t colorScale(Color_t const & input, uint8_t const factor)
+{
+    return Colors::Color(scale8(input >> 16, factor),
+                         scale8(input >> 8, factor),
+                         scale8(input >> 0, factor),
+                         scale8(input >> 24, factor));
+}
+
 Color_t addColors(Color_t const & one, Color_t const & two)
 {
     return Colors::Color(addColorPart(one >> 16, two >> 16),
@@ -54,4 +74,61 @@ Color_t addColors(Color_t const & one, Color_t const & two)
                          addColorPart(one >> 24, two >> 24));
 }
 
+Color_t blendColors(Color_t const & one, Color_t const & two, uint8_t const alpha)
+{
+    uint16_t const alpha256 = static_cast<uint16_t>(alpha) + (alpha >> 7); // [0, 255] -> [0, 256]
+    return Colors::Color(blendColorPart(one >> 16, two >> 16, alpha256),
+                         blendColorPart(one >> 8, two >> 8, alpha256),
+                         blendColorPart(one >> 0, two >> 0, alpha256),
+                         blendColorPart(one >> 24, two >> 24, alpha256));
+}
+
+Color_t colorFromHsv(uint8_t const hue, uint8_t const saturation, uint8_t const value)
+{
+    // Six sectors of the color circle - the sector in the high byte, the position within it in the low byte.
+    uint16_t const hue6 = static_cast<uint16_t>(hue) * 6;
+    uint8_t const sector = hue6 >> 8;
+    uint8_t const fraction = static_cast<uint8_t>(hue6);
+
+    uint8_t const p = scale8(value, 255 - saturation);
+    uint8_t const q = scale8(value, 255 - scale8(saturation, fraction));
+    uint8_t const t = scale8(value, 255 - scale8(saturation, 255 - fraction));
+
+    Color_t color = Black;
+    switch (sector)
+    {
+    case 0:
+    {
+        color = Color(value, t, p);
+        break;
+    }
+    case 1:
+    {
+        color = Color(q, value, p);
+        break;
+    }
+    case 2:
+    {
+        color = Color(p, value, t);
+        break;
+    }
+    case 3:
+    {
+        color = Color(p, q, value);
+        break;
+    }
+    case 4:
+    {
+        color = Color(t, p, value);
+        break;
+    }
+    default:
+    {
+        color = Color(value, p, q);
+        break;
+    }
+    }
+    return color;
+}
+
 }
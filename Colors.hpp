@@ -1,7 +1,8 @@
 #ifndef COLORS_HPP
 #define COLORS_HPP
 
-#include <Arduino.h>
+// Only fixed-width integers are needed - this keeps the color kernels buildable off-target.
+#include <stdint.h>
 
 namespace Colors
 {
@@ -15,11 +16,25 @@ constexpr Color_t Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0)
 }
 
 // Scale components independently to range [0, 255]. Outliers will be clipped.
+// Truncates, i.e. each component is floor(component * scaleFactor) - less than 1 LSB below the exact value.
 Color_t colorScaleBrightness(Color_t const & input, double const & scaleFactor);
 
-// Sum up components of colors independently. Saturates at 0xff for each component.
+// Scale components independently by factor / 255. Integer only - component * (factor + 1) / 256,
+// exact for factor 0 and 255, otherwise less than 1 LSB below the exact value.
+Color_t colorScale(Color_t const & input, uint8_t const factor);
+
+// Sum up components of colors independently. Saturates at 0xff for each component. Exact.
 Color_t addColors(Color_t const & one, Color_t const & two);
 
+// Blend components independently from one [alpha = 0] to two [alpha = 255]. Integer only.
+// Exact for alpha 0 and 255, otherwise less than 1.5 LSB off one + (two - one) * alpha / 255.
+Color_t blendColors(Color_t const & one, Color_t const & two, uint8_t const alpha);
+
+// Hue covers the full color circle in [0, 256) [red at 0, green at 85, blue at 170], saturation and value are [0, 255].
+// Integer only, no division - cheap enough to run per frame. Exact for saturation 0, otherwise less than 2 LSB off
+// the exact conversion.
+Color_t colorFromHsv(uint8_t const hue, uint8_t const saturation, uint8_t const value = 255);
+
 Color_t constexpr Black     = Color(0, 0, 0);
 Color_t constexpr Red       = Color(255, 0, 0);
 Color_t constexpr Green     = Color(0, 255, 0);
@@ -0,0 +1,57 @@
+#include "CurrentLimiter.hpp"
+
+namespace // anonymous namespace
+{
+
+uint16_t milliAmpsFrom(uint32_t const channelSum, uint16_t const pixelCount)
+{
+    // round up - rather overestimate than underestimate
+    return static_cast<uint16_t>((channelSum * CurrentLimiter::milliAmpsPerFullChannel + 254) / 255)
+            + pixelCount * CurrentLimiter::milliAmpsIdlePerPixel;
+}
+
+} // anonymous namespace
+
+namespace CurrentLimiter
+{
+
+uint16_t Limiter::limit(Adafruit_NeoPixel & strip, uint8_t const bytesPerPixel, uint16_t const budgetMilliAmps)
+{
+    uint16_t const pixelCount = strip.numPixels();
+    uint16_t const byteCount = pixelCount * bytesPerPixel;
+    uint8_t * const pixels = strip.getPixels();
+
+    uint32_t channelSum = 0;
+    for (uint16_t i = 0; i < byteCount; ++i)
+    {
+        channelSum += pixels[i];
+    }
+
+    uint16_t milliAmps = milliAmpsFrom(channelSum, pixelCount);
+
+    if (budgetMilliAmps < milliAmps)
+    {
+        uint16_t const idleMilliAmps = pixelCount * milliAmpsIdlePerPixel;
+        uint32_t const allowedChannelSum = (budgetMilliAmps > idleMilliAmps) ?
+                    (static_cast<uint32_t>(budgetMilliAmps - idleMilliAmps) * 255 / milliAmpsPerFullChannel) : 0;
+        // allowedChannelSum < channelSum, hence scale is in [0, 255] [in units of 1/256].
+        uint8_t const scale = static_cast<uint8_t>((allowedChannelSum << 8) / channelSum);
+
+        for (uint16_t i = 0; i < byteCount; ++i)
+        {
+            pixels[i] = (static_cast<uint16_t>(pixels[i]) * scale) >> 8;
+        }
+
+        milliAmps = milliAmpsFrom((channelSum * scale) >> 8, pixelCount);
+    }
+
+    if (peak < milliAmps)
+    {
+        peak = milliAmps;
+    }
+    averageScaled = averageScaled - (averageScaled >> averageShift) + milliAmps;
+
+    return milliAmps;
+}
+
+} // namespace CurrentLimiter
@@ -0,0 +1,58 @@
+#ifndef CURRENTLIMITER_HPP
+#define CURRENTLIMITER_HPP
+
+#include <Adafruit_NeoPixel.h>
+
+namespace CurrentLimiter
+{
+
+// Simple linear current model of a WS2812 pixel [the values of the datasheet, rounded up].
+uint8_t constexpr milliAmpsPerFullChannel = 20; // channel at 255
+uint8_t constexpr milliAmpsIdlePerPixel = 1;    // all channels at 0
+
+/**
+ * @brief The Limiter class Keeps the estimated current of a frame within a budget.
+ * The estimate is computed from the sum of all channel values in the strip's buffer. Only if
+ * the budget is exceeded is the frame scaled down uniformly, so that the hands keep their
+ * relative brightness. Integer math only.
+ */
+class Limiter
+{
+public:
+    /**
+     * @brief limit Estimate the current of the frame in strip and scale it down if necessary.
+     * @param strip frame to limit [must not be shown yet]
+     * @param bytesPerPixel 3 for RGB strips, 4 for RGBW strips
+     * @param budgetMilliAmps supply limit for the whole strip
+     * @return estimated current after limiting in mA
+     */
+    uint16_t limit(Adafruit_NeoPixel & strip, uint8_t const bytesPerPixel, uint16_t const budgetMilliAmps);
+
+    // Statistics of the estimated current after limiting.
+    uint16_t peakMilliAmps() const
+    {
+        return peak;
+    }
+
+    uint16_t averageMilliAmps() const
+    {
+        return static_cast<uint16_t>(averageScaled >> averageShift);
+    }
+
+    void resetStatistics()
+    {
+        peak = 0;
+        averageScaled = 0;
+    }
+
+private:
+    // Exponential moving average over roughly 2^averageShift frames.
+    static uint8_t constexpr averageShift = 5;
+
+    uint16_t peak = 0;
+    uint32_t averageScaled = 0;
+};
+
+} // namespace CurrentLimiter
+
+#endif // CURRENTLIMITER_HPP
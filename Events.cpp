@@ -0,0 +1,194 @@
+#include "Events.hpp"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+namespace // anonymous namespace
+{
+
+// DS3231 alarm mask bits as taken by setA1Time()/setA2Time().
+uint8_t constexpr alarm1MatchHoursMinutesSeconds = 0b00001000;
+uint8_t constexpr alarm2MatchMinutes = 0b01100000;
+
+volatile bool alarmFlag = false;
+
+} // anonymous namespace
+
+ISR(INT0_vect)
+{
+    alarmFlag = true;
+}
+
+namespace Events
+{
+
+bool EventList::insert(Event const & event)
+{
+    if (maximumEventCount <= count)
+    {
+        return false;
+    }
+
+    uint8_t i = count;
+    while ((0 < i) && (events[i - 1].minuteOfDay() > event.minuteOfDay()))
+    {
+        events[i] = events[i - 1];
+        --i;
+    }
+    events[i] = event;
+    ++count;
+    return true;
+}
+
+void EventList::remove(uint8_t const index)
+{
+    if (index >= count)
+    {
+        return;
+    }
+
+    for (uint8_t i = index + 1; i < count; ++i)
+    {
+        events[i - 1] = events[i];
+    }
+    --count;
+}
+
+uint8_t EventList::nextIndex(uint16_t const minuteOfDay) const
+{
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (events[i].minuteOfDay() > minuteOfDay)
+        {
+            return i;
+        }
+    }
+    return (0 < count) ? 0 : count;
+}
+
+bool EventList::isNight(uint16_t const minuteOfDay) const
+{
+    uint8_t latest = count;
+    uint8_t last = count;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if ((EventType::nightStart == events[i].type) || (EventType::nightEnd == events[i].type))
+        {
+            last = i;
+            if (events[i].minuteOfDay() <= minuteOfDay)
+            {
+                latest = i;
+            }
+        }
+    }
+    // Without a night event before minuteOfDay the last one of the previous day applies.
+    if (count == latest)
+    {
+        latest = last;
+    }
+    return (latest < count) && (EventType::nightStart == events[latest].type);
+}
+
+void initialize()
+{
+    DDRD &= ~_BV(DDD2);
+    PORTD |= _BV(PORTD2);
+
+    EICRA = (EICRA & ~(_BV(ISC01) | _BV(ISC00))) | _BV(ISC01); // falling edge
+    EIFR = _BV(INTF0);
+    EIMSK |= _BV(INT0);
+
+    // An alarm which matched before [e.g. while running from the RTC's battery] may hold the line low
+    // already - Scheduler::begin() acknowledges it. It is stale by then, the night mode follows from the list.
+}
+
+bool alarmPending()
+{
+    return alarmFlag;
+}
+
+uint16_t minuteOfDayFromRtc(DS3231 & rtc)
+{
+    bool h12Flag = false;
+    bool pmFlag = false;
+    uint8_t hours = rtc.getHour(h12Flag, pmFlag);
+    if (h12Flag)
+    {
+        hours = (hours % 12) + (pmFlag ? 12 : 0);
+    }
+    return static_cast<uint16_t>(hours) * 60 + rtc.getMinute();
+}
+
+void Scheduler::begin(DS3231 & rtc, EventList const & eventList, uint16_t const minuteOfDay)
+{
+    // Cleared first - an alarm matching while the alarms are reprogrammed sets it again. Cleared
+    // afterwards, its flag in the RTC would hold INT/SQW low and INT0 would never see another edge.
+    alarmFlag = false;
+
+    bool h12Flag = false;
+    bool pmFlag = false;
+    rtc.getHour(h12Flag, pmFlag);
+    use12hMode = h12Flag;
+
+    if (eventList.hourlyChime)
+    {
+        rtc.setA2Time(0, 0, 0, alarm2MatchMinutes, false, use12hMode, false);
+        rtc.turnOnAlarm(2);
+    }
+    else
+    {
+        rtc.turnOffAlarm(2);
+    }
+    rtc.checkIfAlarm(2);
+
+    programNextEvent(rtc, eventList, minuteOfDay);
+    rtc.checkIfAlarm(1);
+}
+
+uint8_t Scheduler::takeDueEvents(DS3231 & rtc, EventList const & eventList)
+{
+    // Cleared first - an alarm matching while the RTC is read sets it again.
+    alarmFlag = false;
+
+    uint8_t dueEvents = 0;
+    if (rtc.checkIfAlarm(1))
+    {
+        for (uint8_t i = 0; i < eventList.count; ++i)
+        {
+            if (eventList.events[i].minuteOfDay() == programmedMinuteOfDay)
+            {
+                dueEvents |= 1 << static_cast<uint8_t>(eventList.events[i].type);
+            }
+        }
+        programNextEvent(rtc, eventList, programmedMinuteOfDay);
+    }
+    if (rtc.checkIfAlarm(2))
+    {
+        dueEvents |= dueChime;
+    }
+    return dueEvents;
+}
+
+void Scheduler::programNextEvent(DS3231 & rtc, EventList const & eventList, uint16_t const minuteOfDay)
+{
+    uint8_t const index = eventList.nextIndex(minuteOfDay);
+    if (index >= eventList.count)
+    {
+        rtc.turnOffAlarm(1);
+        return;
+    }
+
+    Event const & event = eventList.events[index];
+    programmedMinuteOfDay = event.minuteOfDay();
+
+    uint8_t hours = event.hours;
+    bool const pm = (12 <= hours);
+    if (use12hMode)
+    {
+        hours = (0 == hours % 12) ? 12 : (hours % 12);
+    }
+    rtc.setA1Time(0, hours, event.minutes, 0, alarm1MatchHoursMinutesSeconds, false, use12hMode, pm);
+    rtc.turnOnAlarm(1);
+}
+
+} // namespace Events
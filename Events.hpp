@@ -0,0 +1,95 @@
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include <DS3231.h>
+
+#include <stdint.h>
+
+/**
+ * Daily events [wake alarm, night mode start/end] and an hourly chime, timed by the DS3231's alarms.
+ * Alarm 1 is always programmed to the next event of the list, alarm 2 to every full hour. On a match
+ * the RTC pulls its INT/SQW output low [open drain, wired to INT0 - PD2, D2, the internal pull-up is
+ * used] and the INT0 ISR sets a flag. So besides testing that flag nothing runs per frame for events
+ * that are not due - the time is never compared against the list.
+ */
+namespace Events
+{
+
+enum class EventType : uint8_t
+{
+    wake,
+    nightStart,
+    nightEnd
+};
+
+uint8_t constexpr eventTypeCount = static_cast<uint8_t>(EventType::nightEnd) + 1;
+
+struct Event
+{
+    uint8_t hours;      // [0, 24)
+    uint8_t minutes;
+    EventType type;
+
+    uint16_t minuteOfDay() const
+    {
+        return static_cast<uint16_t>(hours) * 60 + minutes;
+    }
+};
+
+uint8_t constexpr maximumEventCount = 8;
+
+// Events sorted by their time of day - stored in EEPROM as is.
+struct EventList
+{
+    uint8_t count = 0;
+    bool hourlyChime = false;
+    Event events[maximumEventCount];
+
+    // Keeps the list sorted, events at the same time stay in insertion order. False if the list is full.
+    bool insert(Event const & event);
+
+    void remove(uint8_t const index);
+
+    // Index of the first event after minuteOfDay [wraps around to the first one of the day], count if empty.
+    uint8_t nextIndex(uint16_t const minuteOfDay) const;
+
+    // Whether the latest night event at or before minuteOfDay [wrapping around] starts the night.
+    bool isNight(uint16_t const minuteOfDay) const;
+};
+
+// Bits of Scheduler::takeDueEvents().
+uint8_t constexpr dueWake = 1 << static_cast<uint8_t>(EventType::wake);
+uint8_t constexpr dueNightStart = 1 << static_cast<uint8_t>(EventType::nightStart);
+uint8_t constexpr dueNightEnd = 1 << static_cast<uint8_t>(EventType::nightEnd);
+uint8_t constexpr dueChime = 1 << 7;
+
+// Configure INT0 for the RTC's INT/SQW output.
+void initialize();
+
+// Set by the INT0 ISR - cleared by Scheduler::begin() and Scheduler::takeDueEvents().
+bool alarmPending();
+
+// Current time of day in minutes [24h] - independent of the RTC's 12h/24h mode.
+uint16_t minuteOfDayFromRtc(DS3231 & rtc);
+
+class Scheduler
+{
+public:
+    // (Re)program both alarms - after boot and whenever the time or the list changed. Acknowledges
+    // alarms that matched before, they are not reported.
+    void begin(DS3231 & rtc, EventList const & eventList, uint16_t const minuteOfDay);
+
+    // Call if alarmPending(): acknowledges the RTC's alarms, programs the next event and returns the due* bits.
+    uint8_t takeDueEvents(DS3231 & rtc, EventList const & eventList);
+
+private:
+    void programNextEvent(DS3231 & rtc, EventList const & eventList, uint16_t const minuteOfDay);
+
+    // Time alarm 1 is programmed to - invalid if the list is empty.
+    uint16_t programmedMinuteOfDay = 0;
+    bool use12hMode = true;
+};
+
+} // namespace Events
+
+#endif // EVENTS_HPP
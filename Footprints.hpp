@@ -0,0 +1,253 @@
+#ifndef FOOTPRINTS_HPP
+#define FOOTPRINTS_HPP
+
+#include <Adafruit_NeoPixel.h>
+#include <avr/pgmspace.h>
+#include <math.h>
+
+#include "Colors.hpp"
+#include "NeoPixelPatterns.hpp"
+#include "RingArithmetic.hpp"
+
+/**
+ * Precomputed kernel footprints. For a fixed kernel the weights F(k + .5 - f) - F(k - .5 - f) of the
+ * pixels k around a hand only depend on its subpixel phase f [position - nearest pixel, in (-.5, .5]].
+ * generate() evaluates them at compile time into a flash table of quantized weights [in 1/255], so
+ * rendering a hand takes per pixel two table lookups, an interpolation between neighbouring phases,
+ * an integer scaling per channel and a saturating add - no floating point and no transcendental function.
+ * Only phases in [0, .5] are stored, negative phases mirror the taps [F is odd around 0 for all
+ * kernels but delta, whose single tap does not depend on the phase].
+ */
+namespace Footprints
+{
+
+// Phases per pixel - the stored ones are 0, 1/phaseCount, ..., 1/2.
+uint8_t constexpr phaseCount = 64;
+uint8_t constexpr storedPhaseCount = phaseCount / 2 + 1;
+
+// Weights of the taps [-radius, radius] for the stored phases, tap index fastest.
+template<uint8_t radius>
+struct Table
+{
+    static uint8_t constexpr tapCount = 2 * radius + 1;
+
+    uint8_t weights[storedPhaseCount * tapCount];
+};
+
+template<typename Kernel>
+constexpr double exactWeight(Kernel const & kernel, int8_t const tap, double const phase)
+{
+    return kernel(tap + .5 - phase) - kernel(tap - .5 - phase);
+}
+
+// Steps do not change between phases - interpolating them would smear the step over a phase interval.
+template<typename Kernel>
+constexpr bool interpolates(Kernel const & kernel)
+{
+    return 0. < kernel.maximumDensity();
+}
+
+template<uint8_t radius, typename Kernel>
+constexpr Table<radius> generate(Kernel const & kernel)
+{
+    Table<radius> table{};
+    for (uint8_t p = 0; p < storedPhaseCount; ++p)
+    {
+        for (int8_t tap = -radius; tap <= radius; ++tap)
+        {
+            double const weight = exactWeight(kernel, tap, static_cast<double>(p) / phaseCount) * 255. + .5;
+            table.weights[p * Table<radius>::tapCount + tap + radius] =
+                    (255. < weight) ? 255 : ((0. > weight) ? 0 : static_cast<uint8_t>(weight));
+        }
+    }
+    return table;
+}
+
+// The weight as renderHands() samples it - phase256 in [0, storedPhaseCount - 1] * 256.
+template<uint8_t radius>
+constexpr uint8_t tableWeight(Table<radius> const & table, bool const interpolate, uint16_t const phase256, uint8_t const tapIndex)
+{
+    uint8_t const row = phase256 >> 8;
+    uint8_t const fraction = interpolate ? static_cast<uint8_t>(phase256) : 0;
+    uint8_t const weight = table.weights[row * Table<radius>::tapCount + tapIndex];
+    if (0 == fraction)
+    {
+        return weight;
+    }
+    uint8_t const nextWeight = table.weights[(row + 1) * Table<radius>::tapCount + tapIndex];
+    return weight + ((static_cast<int16_t>(nextWeight) - weight) * fraction) / 256;
+}
+
+/**
+ * Largest deviation [in LSB at channel value 255] of the sampled table from the exact weights - at the
+ * stored phases, a quarter, halfway and three quarters between them, and for the first taps left out
+ * beyond radius. For a static_assert next to the table.
+ */
+template<uint8_t radius, typename Kernel>
+constexpr double maximumError(Table<radius> const & table, Kernel const & kernel)
+{
+    double maximum = 0.;
+    for (uint16_t phase256 = 0; phase256 <= (storedPhaseCount - 1) * 256; phase256 += 64)
+    {
+        double const phase = phase256 / (256. * phaseCount);
+        for (int8_t tap = -radius - 1; tap <= radius + 1; ++tap)
+        {
+            bool const stored = (-radius <= tap) && (radius >= tap);
+            double const sampled = stored ? tableWeight(table, interpolates(kernel), phase256, tap + radius) : 0.;
+            double const error = fabs(exactWeight(kernel, tap, phase) * 255. - sampled);
+            maximum = (maximum < error) ? error : maximum;
+        }
+    }
+    return maximum;
+}
+
+
+// A table as seen by renderHands() - weights points to flash.
+struct Footprint
+{
+    uint8_t const * weights;
+    uint8_t radius;
+    bool interpolate;
+};
+
+template<uint8_t radius, typename Kernel>
+constexpr Footprint footprintOf(Table<radius> const & table, Kernel const & kernel)
+{
+    return Footprint{table.weights, radius, interpolates(kernel)};
+}
+
+// A hand placed on a ring of pixelCount pixels - the flash row of its phase and its first tap.
+struct Placement
+{
+    uint8_t const * weights;
+    uint8_t tapCount;
+    uint8_t fraction;
+    bool mirrored;
+    uint16_t firstPixel;
+    Colors::Color_t color;
+};
+
+// position is relative to the ring, in [0, pixelCount) - the footprint's 2 * radius + 1 taps at most pixelCount.
+template<typename KernelSelection>
+Placement place(uint16_t const pixelCount, NeoPixelPatterns::Hand<KernelSelection> const & hand, Footprint const & footprint)
+{
+    uint8_t const tapCount = 2 * footprint.radius + 1;
+
+    // Nearest pixel with the phase in (-.5, .5].
+    double const nearest = ceil(hand.position - .5);
+    double const phase = hand.position - nearest;
+    uint16_t phase256 = static_cast<uint16_t>(fabs(phase) * (phaseCount * 256.) + .5);
+    if ((storedPhaseCount - 1) * 256 <= phase256)
+    {
+        phase256 = (storedPhaseCount - 1) * 256;
+    }
+    uint8_t const row = phase256 >> 8;
+
+    // nearest is in [0, pixelCount], the first tap at most a ring behind.
+    int16_t const firstPixel = RingArithmetic::wrapOnce(static_cast<int16_t>(static_cast<int16_t>(nearest) - footprint.radius), static_cast<int16_t>(pixelCount));
+    return Placement{footprint.weights + row * tapCount,
+                     tapCount,
+                     footprint.interpolate ? static_cast<uint8_t>(phase256) : static_cast<uint8_t>(0),
+                     0. > phase,
+                     static_cast<uint16_t>(firstPixel),
+                     hand.color};
+}
+
+// Weight of tap t [counted from the first pixel] - interpolated between the row and the next one.
+inline uint8_t tapWeight(Placement const & placement, uint8_t const t)
+{
+    uint8_t const tapIndex = placement.mirrored ? (placement.tapCount - 1 - t) : t;
+    uint8_t weight = pgm_read_byte(placement.weights + tapIndex);
+    if (0 != placement.fraction)
+    {
+        uint8_t const nextWeight = pgm_read_byte(placement.weights + placement.tapCount + tapIndex);
+        weight += ((static_cast<int16_t>(nextWeight) - weight) * placement.fraction) / 256;
+    }
+    return weight;
+}
+
+// Renders the hands selected by handMask [bit h: hands[h]] onto the ring occupying the strip's pixels
+// [firstPixel, firstPixel + pixelCount) in a single pass - every pixel is written once, the ring's previous
+// content is replaced. Per pixel the hands are added in order, as by clearing and adding them one by one.
+template<typename KernelSelection, uint8_t handCount, typename FootprintOf>
+void renderRing(Adafruit_NeoPixel & strip,
+                uint16_t const firstPixel,
+                uint16_t const pixelCount,
+                NeoPixelPatterns::Hand<KernelSelection> const (&hands)[handCount],
+                FootprintOf const & footprintOf,
+                uint8_t const handMask = 0xFF)
+{
+    static_assert(8 >= handCount, "handMask has a bit per hand.");
+
+    Placement placements[handCount] = {};
+    // Tap of each placed hand at the current pixel - taps at or beyond tapCount do not touch it.
+    uint16_t taps[handCount] = {};
+    uint8_t placedCount = 0;
+    for (uint8_t h = 0; h < handCount; ++h)
+    {
+        if (0 != (handMask & (1 << h)))
+        {
+            placements[placedCount] = place(pixelCount, hands[h], footprintOf(hands[h].kernel));
+            taps[placedCount] = (0 == placements[placedCount].firstPixel) ? 0 : (pixelCount - placements[placedCount].firstPixel);
+            ++placedCount;
+        }
+    }
+
+    uint16_t pixel = 0;
+    while (pixel < pixelCount)
+    {
+        // Pixels before the next tap of any hand stay dark.
+        uint16_t darkCount = pixelCount - pixel;
+        for (uint8_t p = 0; p < placedCount; ++p)
+        {
+            uint16_t const untilFirstTap = (placements[p].tapCount > taps[p]) ? 0 : (pixelCount - taps[p]);
+            darkCount = (untilFirstTap < darkCount) ? untilFirstTap : darkCount;
+        }
+        uint16_t const step = (0 == darkCount) ? 1 : darkCount;
+
+        if (0 == darkCount)
+        {
+            Colors::Color_t color = 0;
+            for (uint8_t p = 0; p < placedCount; ++p)
+            {
+                if (placements[p].tapCount > taps[p])
+                {
+                    uint8_t const weight = tapWeight(placements[p], taps[p]);
+                    if (0 != weight)
+                    {
+                        color = Colors::addColors(color, Colors::colorScale(placements[p].color, weight));
+                    }
+                }
+            }
+            strip.setPixelColor(firstPixel + pixel, color);
+        }
+        else
+        {
+            for (uint16_t i = pixel; i < pixel + darkCount; ++i)
+            {
+                strip.setPixelColor(firstPixel + i, 0);
+            }
+        }
+
+        pixel += step;
+        for (uint8_t p = 0; p < placedCount; ++p)
+        {
+            // Dark runs end at the first tap of a hand at the latest - taps[p] + step stays within pixelCount.
+            taps[p] = (pixelCount <= taps[p] + step) ? (taps[p] + step - pixelCount) : (taps[p] + step);
+        }
+    }
+}
+
+// Renders all hands from their footprints onto the whole strip as one ring - the strip's previous content is replaced.
+// footprintOf(kernel) has to return the Footprint of the selected kernel.
+template<typename KernelSelection, uint8_t handCount, typename FootprintOf>
+void renderHands(Adafruit_NeoPixel & strip,
+                 NeoPixelPatterns::Hand<KernelSelection> const (&hands)[handCount],
+                 FootprintOf const & footprintOf)
+{
+    renderRing(strip, 0, strip.numPixels(), hands, footprintOf);
+}
+
+} // namespace Footprints
+
+#endif // FOOTPRINTS_HPP
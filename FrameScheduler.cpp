@@ -0,0 +1,46 @@
+#include "FrameScheduler.hpp"
+
+namespace FrameScheduler
+{
+
+bool Scheduler::isDue(unsigned long const now) const
+{
+    // Signed difference - correct across the millis() overflow.
+    return invalid || (0 <= static_cast<long>(now - nextFrameTime));
+}
+
+void Scheduler::invalidate()
+{
+    invalid = true;
+}
+
+void Scheduler::frameRendered(unsigned long const now, double const millisUntilChange)
+{
+    uint16_t interval = maximumIntervalMs;
+    if (static_cast<double>(minimumIntervalMs) >= millisUntilChange)
+    {
+        interval = minimumIntervalMs;
+    }
+    else if (static_cast<double>(maximumIntervalMs) > millisUntilChange)
+    {
+        interval = static_cast<uint16_t>(millisUntilChange);
+    }
+
+    invalid = false;
+    nextFrameTime = now + interval;
+    if (UINT16_MAX > frameCount)
+    {
+        ++frameCount;
+    }
+}
+
+uint16_t Scheduler::takeDeciFramesPerSecond(unsigned long const now)
+{
+    unsigned long const duration = now - countStartTime;
+    uint16_t const deciFramesPerSecond = (0 == duration) ? 0 : static_cast<uint16_t>(static_cast<uint32_t>(frameCount) * 10000 / duration);
+    frameCount = 0;
+    countStartTime = now;
+    return deciFramesPerSecond;
+}
+
+} // namespace FrameScheduler
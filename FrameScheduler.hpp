@@ -0,0 +1,47 @@
+#ifndef FRAMESCHEDULER_HPP
+#define FRAMESCHEDULER_HPP
+
+#include <stdint.h>
+
+/**
+ * Decides which loop() cycles render a frame.
+ * After each frame the caller passes the time until the next visible change [e.g. from
+ * NeoPixelPatterns::millisUntilVisibleChange()], the next frame is due then - but not
+ * earlier than minimumIntervalMs and not later than maximumIntervalMs after this one.
+ * Also counts the rendered frames for reporting the achieved frame rate.
+ */
+namespace FrameScheduler
+{
+
+class Scheduler
+{
+public:
+    constexpr Scheduler(uint16_t const minimumIntervalMs, uint16_t const maximumIntervalMs)
+        : minimumIntervalMs(minimumIntervalMs)
+        , maximumIntervalMs(maximumIntervalMs)
+    {
+        // intentionally empty
+    }
+
+    bool isDue(unsigned long const now) const;
+
+    // The next isDue() returns true.
+    void invalidate();
+
+    void frameRendered(unsigned long const now, double const millisUntilChange);
+
+    // Average since the previous call, in 1/10 frames per second.
+    uint16_t takeDeciFramesPerSecond(unsigned long const now);
+
+private:
+    uint16_t minimumIntervalMs;
+    uint16_t maximumIntervalMs;
+    bool invalid = true;
+    unsigned long nextFrameTime = 0;
+    uint16_t frameCount = 0;
+    unsigned long countStartTime = 0;
+};
+
+} // namespace FrameScheduler
+
+#endif // FRAMESCHEDULER_HPP
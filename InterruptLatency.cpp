@@ -0,0 +1,57 @@
+#include "InterruptLatency.hpp"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+namespace // anonymous namespace
+{
+
+static_assert(8000000 == F_CPU, "Timer2 settings assume F_CPU = 8 MHz.");
+uint8_t constexpr microsPerTick = 4;        // prescaler 32
+uint8_t constexpr ticksPerPeriod = 250;     // 1 ms
+
+volatile uint8_t maximumTicks = 0;
+
+} // anonymous namespace
+
+
+ISR(TIMER2_COMPA_vect)
+{
+    // In CTC mode the counter restarted at the compare match - so it holds the ticks since then.
+    uint8_t const ticks = TCNT2;
+    if (ticks > maximumTicks)
+    {
+        maximumTicks = ticks;
+    }
+}
+
+
+namespace InterruptLatency
+{
+
+void initialize()
+{
+    TCCR2A = _BV(WGM21);            // CTC
+    TCCR2B = _BV(CS21) | _BV(CS20); // F_CPU / 32
+    OCR2A = ticksPerPeriod - 1;
+    TCNT2 = 0;
+    TIMSK2 = _BV(OCIE2A);
+}
+
+uint16_t maximumMicros()
+{
+    uint8_t ticks = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ticks = maximumTicks;
+    }
+    return static_cast<uint16_t>(ticks) * microsPerTick;
+}
+
+void reset()
+{
+    maximumTicks = 0;
+}
+
+} // namespace InterruptLatency
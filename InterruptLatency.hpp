@@ -0,0 +1,25 @@
+#ifndef INTERRUPTLATENCY_HPP
+#define INTERRUPTLATENCY_HPP
+
+#include <stdint.h>
+
+/**
+ * Worst-case interrupt latency probe on Timer2.
+ * A compare match interrupt is requested every millisecond, the ISR reads how far the
+ * timer has already counted since the match. This is the time the interrupt was held
+ * off [e.g. by cli() in Adafruit_NeoPixel::show() or by other ISRs] plus a constant
+ * entry overhead of a few microseconds.
+ * Resolution is 4 us, latencies up to 1 ms are resolved [longer ones wrap around].
+ */
+namespace InterruptLatency
+{
+
+void initialize();
+
+uint16_t maximumMicros();
+
+void reset();
+
+} // namespace InterruptLatency
+
+#endif // INTERRUPTLATENCY_HPP
@@ -0,0 +1,68 @@
+#include "Memory.hpp"
+
+#include <avr/io.h>
+
+// Provided by the linker script and avr-libc's malloc.
+extern "C" uint8_t _end;
+extern "C" char * __brkval;
+extern "C" char * __malloc_heap_start;
+
+namespace // anonymous namespace
+{
+
+uint8_t * stackPointer()
+{
+    return reinterpret_cast<uint8_t *>(SP);
+}
+
+uint8_t const * heapTopPointer()
+{
+    return reinterpret_cast<uint8_t const *>((nullptr != __brkval) ? __brkval : __malloc_heap_start);
+}
+
+} // anonymous namespace
+
+
+#if defined(__AVR__)
+// Runs before .data/.bss are initialized and before any constructor - SP is set up already.
+extern "C" void paintStack() __attribute__((naked, used, section(".init3")));
+
+extern "C" void paintStack()
+{
+    // No calls in here - naked, so nothing may touch the stack.
+    uint8_t * p = &_end;
+    uint8_t * const stackPointerAtBoot = reinterpret_cast<uint8_t *>(SP);
+    while (p <= stackPointerAtBoot)
+    {
+        *p++ = Memory::canary;
+    }
+}
+#endif
+
+
+namespace Memory
+{
+
+uint16_t heapTop()
+{
+    return static_cast<uint16_t>(reinterpret_cast<uintptr_t>(heapTopPointer()));
+}
+
+uint16_t currentFreeBytes()
+{
+    return static_cast<uint16_t>(stackPointer() - heapTopPointer() + 1);
+}
+
+uint16_t minimumFreeBytes()
+{
+    uint8_t const * const top = heapTopPointer();
+    uint8_t const * const stackPointerNow = stackPointer();
+    uint8_t const * p = top;
+    while ((p <= stackPointerNow) && (canary == *p))
+    {
+        ++p;
+    }
+    return static_cast<uint16_t>(p - top);
+}
+
+} // namespace Memory
@@ -0,0 +1,32 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <stdint.h>
+
+/**
+ * SRAM headroom monitoring.
+ * At boot [.init3, before any constructor runs] everything between the static data and the
+ * stack pointer is painted with a canary value. The stack grows down into it, the heap
+ * [malloc] grows up into it - the bytes still holding the canary between the heap top and
+ * the deepest stack use are what never has been used.
+ * A variable coincidentally holding the canary value at the deepest stack position makes the
+ * result slightly optimistic [by a few bytes at most].
+ */
+namespace Memory
+{
+
+// Painted at boot - on the host [tools/canary] into a fake SRAM by the test itself.
+uint8_t constexpr canary = 0xc5;
+
+// Address of the first byte above the heap [or above the static data, if nothing was allocated].
+uint16_t heapTop();
+
+// Bytes from the heap top up to the stack pointer now - SP points at the next free byte.
+uint16_t currentFreeBytes();
+
+// Bytes between the heap top and the deepest stack position since boot.
+uint16_t minimumFreeBytes();
+
+} // namespace Memory
+
+#endif // MEMORY_HPP
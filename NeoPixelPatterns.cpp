@@ -1,20 +1,44 @@
 #include "NeoPixelPatterns.hpp"
 
-namespace NeoPixelPatterns
+namespace // anonymous namespace
 {
 
-double brightnessFunctionMountain(const double x)
+// Every int16_t value against the reference templates [RingArithmetic must not change any result].
+template<uint16_t modulus>
+constexpr bool ringArithmeticMatches()
 {
-    double constexpr halfWidthHalfMaximum = .01;
-    double constexpr halfWidthHalfMaximumSqrt = sqrt(halfWidthHalfMaximum);
-    double constexpr normalization = 2. * atan(1./(2 * halfWidthHalfMaximumSqrt));
-    return atan(x/halfWidthHalfMaximumSqrt) / normalization;
+    using Ring = RingArithmetic::Ring<modulus>;
+    int16_t const range = modulus;
+    for (int32_t i = INT16_MIN; i <= INT16_MAX; ++i)
+    {
+        int16_t const value = i;
+        if ((Ring::normalize(value) != NeoPixelPatterns::normalizePosition(value, range))
+            || (Ring::symmetrize(value) != NeoPixelPatterns::symmetrizePosition(value, range))
+            || ((0 == modulus % 2) && (Ring::circle(value) != NeoPixelPatterns::circlePosition(value, static_cast<int16_t>(range / 2)))))
+        {
+            return false;
+        }
+        if ((-range <= value) && (2 * range > value) && (RingArithmetic::wrapOnce(value, range) != NeoPixelPatterns::normalizePosition(value, range)))
+        {
+            return false;
+        }
+        if ((-range <= value) && (range > value)
+            && (RingArithmetic::symmetrizeOnce(value, range) != NeoPixelPatterns::symmetrizePosition(value, range)))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-double brightnessFunctionDelta(const double x)
+static_assert(ringArithmeticMatches<12>(), "Ring<12> differs from the reference.");
+static_assert(ringArithmeticMatches<16>(), "Ring<16> differs from the reference.");
+static_assert(ringArithmeticMatches<60>(), "Ring<60> differs from the reference.");
+
+} // anonymous namespace
+
+namespace NeoPixelPatterns
 {
-    return (x > 0.) ? 1. : 0.;
-}
 
 template<>
 double normalizePosition(const double & position, const double & range)
@@ -34,35 +58,4 @@ unsigned long normalizePosition(const unsigned long & position, const unsigned l
     return (position % range);
 }
 
-
-void addColorsWrapping(Adafruit_NeoPixel & strip,
-					   double const position,
-					   BrightnessFunctionType brightnessFunction,
-					   Colors::Color_t const &color)
-{
-    double const numberOfPixelsDouble = static_cast<double>(strip.numPixels());
-	  double previousPosition = symmetrizePosition(-1. * position - .5, numberOfPixelsDouble);
-    double previousBrightness = brightnessFunction(previousPosition);
-    for (unsigned i = 0; i < strip.numPixels(); ++i)
-    {
-        double const nextPosition = symmetrizePosition(previousPosition + 1., numberOfPixelsDouble);
-        double const nextBrightness = brightnessFunction(nextPosition);
-        // Where the brightness wraps around, previousBrightness has to be recalculated.
-        if (nextPosition < previousPosition)
-        {
-            previousBrightness = brightnessFunction(nextPosition - 1.);
-        }
-
-        // As written above: brightness = F(i+.5) - F(i-.5)
-        double const brightness = nextBrightness - previousBrightness;
-
-        Colors::Color_t const newColor = Colors::colorScaleBrightness(color, brightness);
-		
-		    strip.setPixelColor(i, Colors::addColors(newColor, strip.getPixelColor(i)));
-
-        previousBrightness = nextBrightness;
-		    previousPosition = nextPosition;
-    }
-}
-
 } // NeoPixelPatterns
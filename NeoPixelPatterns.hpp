@@ -5,37 +5,187 @@
 #include <Adafruit_NeoPixel.h>
 
 #include "Colors.hpp"
+#include "RingArithmetic.hpp"
 
 
 namespace NeoPixelPatterns
 {
 
 /**
- * BrightnessFunctionType This type of function shall be used to calculate pixel brightness.
- * Please note, that this does not calculate the brightness of a single pixel value itself,
- * but is supposed to be the analytic integral of the desired color profile.
+ * Brightness kernels are functors used to calculate pixel brightness.
+ * Please note, that they do not calculate the brightness of a single pixel value itself,
+ * but are supposed to be the analytic integral of the desired color profile.
  * This is so, that for f(x) the pixel brightness of pixel i can be calculated using
  *  brightness(i) = F(i+.5) - F(i-.5),
  * where F(x) is the brightness function [F(x) = int f(x) dx]. Please note that this
  * function should be normalized, so that:
  *  max(brightness(i)) <= 1,
  *  min(brightness(i)) >= 0.
+ * All kernels but delta are normalized so that a hand centered on a pixel lights it with 1.
+ * A kernel has to provide
+ *  constexpr double operator()(double x) const;  // F(x) - constexpr for generating footprints
+ *  constexpr double maximumDensity() const;  // max(f(x)), 0 for steps
+ * and is passed by type to addColorsWrapping(), so that it can be inlined into the pixel loop.
+ * The widths of all kernels are given as half width at half maximum [in pixels] of f(x).
  */
-typedef double(*BrightnessFunctionType)(double);
 
 /**
- * @brief brightnessFunctionMountain Integral for f(x) = b/(1 + x^2/a).
- * @param x position
- * @return brightness in [0,1]
+ * @brief Integral of delta(x).
+ */
+struct KernelDelta
+{
+    constexpr double operator()(double const x) const
+    {
+        return (x > 0.) ? 1. : 0.;
+    }
+
+    // A step - it changes pixels only where the position crosses a pixel border.
+    constexpr double maximumDensity() const
+    {
+        return 0.;
+    }
+};
+
+/**
+ * @brief Integral for f(x) = b/(1 + x^2/w^2) with w the half width at half maximum.
  * From normalization 1 != F(.5) - F(-.5) it results:
- *  b = 1/(2*sqrt(a) * atan(1/(2*sqrt(a)))).
+ *  b = 1/(2*w * atan(1/(2*w))).
  */
-double brightnessFunctionMountain(double const x);
+struct KernelMountain
+{
+    constexpr explicit KernelMountain(double const halfWidthHalfMaximum)
+        : inverseWidth(1. / halfWidthHalfMaximum)
+        , gain(1. / (2. * atan(1. / (2. * halfWidthHalfMaximum))))
+    {
+        // intentionally empty
+    }
+
+    constexpr double operator()(double const x) const
+    {
+        return atan(x * inverseWidth) * gain;
+    }
+
+    constexpr double maximumDensity() const
+    {
+        return inverseWidth * gain;
+    }
+
+    double inverseWidth;
+    double gain;
+};
 
 /**
- * @brief Integral of delta(x).
+ * @brief Integral of a Gaussian, approximated by the cubic B-spline [support +-2 * scale].
+ * The B-spline is piecewise polynomial, so this needs no transcendental function at all.
+ */
+struct KernelGaussian
+{
+    // B(t) = B(0)/2 at t = 0.7224
+    static constexpr double halfWidthHalfMaximumAtUnitScale = .7224;
+
+    constexpr explicit KernelGaussian(double const halfWidthHalfMaximum)
+        : inverseScale(halfWidthHalfMaximumAtUnitScale / halfWidthHalfMaximum)
+        , gain(1. / (2. * integral(.5 * halfWidthHalfMaximumAtUnitScale / halfWidthHalfMaximum)))
+    {
+        // intentionally empty
+    }
+
+    constexpr double operator()(double const x) const
+    {
+        return (0. > x) ? (-integral(-x * inverseScale) * gain) : (integral(x * inverseScale) * gain);
+    }
+
+    constexpr double maximumDensity() const
+    {
+        // B(0) = 2/3
+        return 2. / 3. * inverseScale * gain;
+    }
+
+    // Integral of the unit cubic B-spline from 0 to t, t >= 0.
+    static constexpr double integral(double const t)
+    {
+        if (1. > t)
+        {
+            return (4. * t - 2. * t * t * t + .75 * t * t * t * t) / 6.;
+        }
+        else if (2. > t)
+        {
+            double const rest = 2. - t;
+            return .5 - rest * rest * rest * rest / 24.;
+        }
+        else
+        {
+            return .5;
+        }
+    }
+
+    double inverseScale;
+    double gain;
+};
+
+/**
+ * @brief Integral of a triangle [support +-2 * halfWidthHalfMaximum].
+ */
+struct KernelTriangle
+{
+    constexpr explicit KernelTriangle(double const halfWidthHalfMaximum)
+        : inverseHalfBase(1. / (2. * halfWidthHalfMaximum))
+        , gain(1. / (2. * integral(.5 / (2. * halfWidthHalfMaximum))))
+    {
+        // intentionally empty
+    }
+
+    constexpr double operator()(double const x) const
+    {
+        return (0. > x) ? (-integral(-x * inverseHalfBase) * gain) : (integral(x * inverseHalfBase) * gain);
+    }
+
+    constexpr double maximumDensity() const
+    {
+        return inverseHalfBase * gain;
+    }
+
+    // Integral of the unit triangle 1 - |t| from 0 to t, t >= 0.
+    static constexpr double integral(double const t)
+    {
+        return (1. > t) ? (t - .5 * t * t) : .5;
+    }
+
+    double inverseHalfBase;
+    double gain;
+};
+
+/**
+ * @brief Integral of a raised cosine [Hann window, support +-2 * halfWidthHalfMaximum].
  */
-double brightnessFunctionDelta(const double x);
+struct KernelCosine
+{
+    constexpr explicit KernelCosine(double const halfWidthHalfMaximum)
+        : inverseHalfBase(1. / (2. * halfWidthHalfMaximum))
+        , gain(1. / (2. * integral(.5 / (2. * halfWidthHalfMaximum))))
+    {
+        // intentionally empty
+    }
+
+    constexpr double operator()(double const x) const
+    {
+        return (0. > x) ? (-integral(-x * inverseHalfBase) * gain) : (integral(x * inverseHalfBase) * gain);
+    }
+
+    constexpr double maximumDensity() const
+    {
+        return inverseHalfBase * gain;
+    }
+
+    // Integral of (1 + cos(pi * t)) / 2 from 0 to t, t >= 0.
+    static constexpr double integral(double const t)
+    {
+        return (1. > t) ? (.5 * (t + sin(M_PI * t) / M_PI)) : .5;
+    }
+
+    double inverseHalfBase;
+    double gain;
+};
 
 /**
  * Normalize a double position with regard to a range.
@@ -46,7 +196,7 @@ typedef double(*PositionNormalizationFunctionType)(double, double);
 
 // move position to [0, range)
 template<typename T>
-T normalizePosition(T const & position, T const & range)
+constexpr T normalizePosition(T const & position, T const & range)
 {
     return (((position % range) + range) % range);
 }
@@ -71,7 +221,7 @@ unsigned long normalizePosition(const unsigned long & position, const unsigned l
 // 2 -> -2
 // 3 -> -1
 template<typename T>
-T symmetrizePosition(T const & position, T const & range)
+constexpr T symmetrizePosition(T const & position, T const & range)
 {
     T const normalizedPosition = normalizePosition(position, range);
     T const rangeHalf = range / 2.;
@@ -96,7 +246,7 @@ T symmetrizePosition(T const & position, T const & range)
  *     0        2T      *
  */
 template<typename T>
-T circlePosition(T const & position, T const & range)
+constexpr T circlePosition(T const & position, T const & range)
 {
     T const inputRange = 2 * range;
     T const normalizedPosition = normalizePosition(position, inputRange);
@@ -105,10 +255,138 @@ T circlePosition(T const & position, T const & range)
 
 
 // position in pixels, i.e. [0, strip.numPixels()).
+// Each pixel receives colorScaleBrightness(color, F(i+.5) - F(i-.5)), saturating-added to its previous value.
+// This is the reference behaviour any optimized renderer has to reproduce [per channel within the
+// truncation of colorScaleBrightness].
+template<typename Kernel>
 void addColorsWrapping(Adafruit_NeoPixel & strip,
-					   double const position,
-					   BrightnessFunctionType brightnessFunction,
-					   Colors::Color_t const &color);
+                       double const position,
+                       Kernel const & brightnessFunction,
+                       Colors::Color_t const &color)
+{
+    double const numberOfPixelsDouble = static_cast<double>(strip.numPixels());
+    double previousPosition = symmetrizePosition(-1. * position - .5, numberOfPixelsDouble);
+    double previousBrightness = brightnessFunction(previousPosition);
+    for (unsigned i = 0; i < strip.numPixels(); ++i)
+    {
+        // One pixel further never wraps more than once.
+        double const nextPosition = RingArithmetic::symmetrizeOnce(previousPosition + 1., numberOfPixelsDouble);
+        double const nextBrightness = brightnessFunction(nextPosition);
+        // Where the brightness wraps around, previousBrightness has to be recalculated.
+        if (nextPosition < previousPosition)
+        {
+            previousBrightness = brightnessFunction(nextPosition - 1.);
+        }
+
+        // As written above: brightness = F(i+.5) - F(i-.5)
+        double const brightness = nextBrightness - previousBrightness;
+
+        Colors::Color_t const newColor = Colors::colorScaleBrightness(color, brightness);
+
+        strip.setPixelColor(i, Colors::addColors(newColor, strip.getPixelColor(i)));
+
+        previousBrightness = nextBrightness;
+        previousPosition = nextPosition;
+    }
+}
+
+
+/**
+ * A hand [or marker] for renderHands(): its position in pixels, the kernel selection passed to
+ * the kernel evaluation and its color at brightness 1.
+ */
+template<typename KernelSelection>
+struct Hand
+{
+    double position;
+    KernelSelection kernel;
+    Colors::Color_t color;
+};
+
+// Renders all hands in a single pass over the strip - every pixel is written exactly once, its
+// previous content is replaced. Per pixel the result equals clearing the strip and calling
+// addColorsWrapping() for each hand in turn.
+// evaluateKernel(kernel, x) has to return F(x) of the selected kernel.
+template<typename KernelSelection, uint8_t handCount, typename EvaluateKernel>
+void renderHands(Adafruit_NeoPixel & strip,
+                 Hand<KernelSelection> const (&hands)[handCount],
+                 EvaluateKernel const & evaluateKernel)
+{
+    double const numberOfPixelsDouble = static_cast<double>(strip.numPixels());
+    double previousPositions[handCount];
+    double previousBrightnesses[handCount];
+    for (uint8_t h = 0; h < handCount; ++h)
+    {
+        previousPositions[h] = symmetrizePosition(-1. * hands[h].position - .5, numberOfPixelsDouble);
+        previousBrightnesses[h] = evaluateKernel(hands[h].kernel, previousPositions[h]);
+    }
+
+    for (unsigned i = 0; i < strip.numPixels(); ++i)
+    {
+        Colors::Color_t pixelColor = Colors::Black;
+        for (uint8_t h = 0; h < handCount; ++h)
+        {
+            double const nextPosition = RingArithmetic::symmetrizeOnce(previousPositions[h] + 1., numberOfPixelsDouble);
+            double const nextBrightness = evaluateKernel(hands[h].kernel, nextPosition);
+            // Where the brightness wraps around, previousBrightness has to be recalculated.
+            if (nextPosition < previousPositions[h])
+            {
+                previousBrightnesses[h] = evaluateKernel(hands[h].kernel, nextPosition - 1.);
+            }
+
+            double const brightness = nextBrightness - previousBrightnesses[h];
+            pixelColor = Colors::addColors(pixelColor, Colors::colorScaleBrightness(hands[h].color, brightness));
+
+            previousBrightnesses[h] = nextBrightness;
+            previousPositions[h] = nextPosition;
+        }
+        strip.setPixelColor(i, pixelColor);
+    }
+}
+
+
+// Time [ms] for which the exact channel values of renderHands() change by less than 1 LSB [the
+// truncated ones by at most 1 LSB per hand], with the hands moving at velocities [pixels per ms, >= 0].
+// A pixel's brightness changes with the position at most by max(f(x)) - steps change only where
+// the position crosses a pixel border.
+// maximumDensity(kernel) has to return max(f(x)) of the selected kernel, 0 for steps.
+template<typename KernelSelection, uint8_t handCount, typename MaximumDensity>
+double millisUntilVisibleChange(Hand<KernelSelection> const (&hands)[handCount],
+                                double const (&velocities)[handCount],
+                                MaximumDensity const & maximumDensity)
+{
+    double lsbPerMilli = 0.;
+    double millisUntilStep = INFINITY;
+    for (uint8_t h = 0; h < handCount; ++h)
+    {
+        if (0. >= velocities[h])
+        {
+            continue;
+        }
+
+        double const density = maximumDensity(hands[h].kernel);
+        if (0. < density)
+        {
+            uint8_t const red = hands[h].color >> 16;
+            uint8_t const green = hands[h].color >> 8;
+            uint8_t const blue = hands[h].color;
+            uint8_t const maximumChannel = (red > green) ? ((red > blue) ? red : blue) : ((green > blue) ? green : blue);
+            lsbPerMilli += maximumChannel * density * velocities[h];
+        }
+        else
+        {
+            double const pixelsUntilBorder = floor(hands[h].position + .5) + .5 - hands[h].position;
+            double const millisUntilBorder = pixelsUntilBorder / velocities[h];
+            if (millisUntilStep > millisUntilBorder)
+            {
+                millisUntilStep = millisUntilBorder;
+            }
+        }
+    }
+
+    double const millisUntilLsb = (0. < lsbPerMilli) ? (1. / lsbPerMilli) : INFINITY;
+    return (millisUntilStep < millisUntilLsb) ? millisUntilStep : millisUntilLsb;
+}
 
 
 } // NeoPixelPatterns
@@ -0,0 +1,142 @@
+#include "Profiler.hpp"
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+// End of the program code - provided by the linker script.
+extern "C" char _etext;
+
+namespace // anonymous namespace
+{
+
+static_assert(8000000 == F_CPU, "Timer2 settings assume F_CPU = 8 MHz.");
+uint8_t constexpr ticksPerPeriod = 241;     // prescaler 32: 964 us, not a divisor of Timer0's 2048 us
+
+uint16_t buckets[Profiler::bucketCount];
+uint32_t sampleCount = 0;
+uint8_t bucketShift = 0;    // applied to byte addresses
+
+} // anonymous namespace
+
+
+// Called from the ISR only - not in the anonymous namespace, the assembler needs an unmangled name.
+extern "C" void profilerRecordSample(uint16_t const wordAddress) __attribute__((used));
+
+extern "C" void profilerRecordSample(uint16_t const wordAddress)
+{
+    uint8_t const index = static_cast<uint8_t>((static_cast<uint32_t>(wordAddress) << 1) >> bucketShift);
+    if (Profiler::bucketCount <= index)
+    {
+        // Bootloader section or similar.
+        return;
+    }
+
+    if (0xffff == buckets[index])
+    {
+        for (uint16_t & bucket : buckets)
+        {
+            bucket >>= 1;
+        }
+        sampleCount >>= 1;
+    }
+    ++buckets[index];
+    ++sampleCount;
+}
+
+
+// Naked: the return address has to be found at a known offset from the stack pointer.
+ISR(TIMER2_COMPB_vect, ISR_NAKED)
+{
+    asm volatile(
+        // Save everything a call may clobber - 15 bytes.
+        "push r0                \n"
+        "in   r0, __SREG__      \n"
+        "push r0                \n"
+        "push r1                \n"
+        "clr  r1                \n"
+        "push r18               \n"
+        "push r19               \n"
+        "push r20               \n"
+        "push r21               \n"
+        "push r22               \n"
+        "push r23               \n"
+        "push r24               \n"
+        "push r25               \n"
+        "push r26               \n"
+        "push r27               \n"
+        "push r30               \n"
+        "push r31               \n"
+        // SP points below the last push, the return address [big endian, in words] follows the 15 bytes.
+        "in   r30, __SP_L__     \n"
+        "in   r31, __SP_H__     \n"
+        "ldd  r25, Z+16         \n"
+        "ldd  r24, Z+17         \n"
+        "call profilerRecordSample \n"
+        "pop  r31               \n"
+        "pop  r30               \n"
+        "pop  r27               \n"
+        "pop  r26               \n"
+        "pop  r25               \n"
+        "pop  r24               \n"
+        "pop  r23               \n"
+        "pop  r22               \n"
+        "pop  r21               \n"
+        "pop  r20               \n"
+        "pop  r19               \n"
+        "pop  r18               \n"
+        "pop  r1                \n"
+        "pop  r0                \n"
+        "out  __SREG__, r0      \n"
+        "pop  r0                \n"
+        "reti                   \n"
+    );
+}
+
+
+namespace Profiler
+{
+
+void initialize()
+{
+    // Smallest bucket size covering the program code.
+    uint16_t const textEnd = static_cast<uint16_t>(reinterpret_cast<uintptr_t>(&_etext));
+    bucketShift = 0;
+    while ((textEnd >> bucketShift) >= bucketCount)
+    {
+        ++bucketShift;
+    }
+
+    TCCR2A = _BV(WGM21);            // CTC
+    TCCR2B = _BV(CS21) | _BV(CS20); // F_CPU / 32
+    OCR2A = ticksPerPeriod - 1;
+    OCR2B = 0;
+    TCNT2 = 0;
+    TIMSK2 = _BV(OCIE2B);
+}
+
+void dump(Print & print)
+{
+    TIMSK2 &= ~_BV(OCIE2B);
+
+    print.print("PROFILE ");
+    print.print(sampleCount, DEC);
+    print.print(' ');
+    print.print(bucketShift, DEC);
+    print.println();
+    for (uint8_t i = 0; i < bucketCount; ++i)
+    {
+        if (0 != buckets[i])
+        {
+            print.print(static_cast<uint16_t>(i) << bucketShift, HEX);
+            print.print(' ');
+            print.print(buckets[i], DEC);
+            print.println();
+        }
+    }
+    print.println("END");
+
+    TIMSK2 |= _BV(OCIE2B);
+}
+
+} // namespace Profiler
@@ -0,0 +1,36 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <stdint.h>
+
+class Print;
+
+/**
+ * Statistical sampling profiler on Timer2.
+ * Roughly every millisecond a compare match interrupt reads the return address of the
+ * interrupted code and counts it in a histogram of the flash [.text] in SRAM. The period is
+ * chosen not to be a multiple of the Timer0 [millis()] period, so the samples do not lock
+ * to the millis() interrupt.
+ * Code running with interrupts disabled [other ISRs, Adafruit_NeoPixel::show(), ...] is
+ * attributed to the instruction which enables them again.
+ * When a bucket would overflow all buckets are halved - the proportions are kept.
+ * Use tools/profile.py to map the dump to the symbols of the ELF.
+ */
+namespace Profiler
+{
+
+uint8_t constexpr bucketCount = 128;
+
+void initialize();
+
+/**
+ * Prints the histogram [sampling is paused meanwhile]:
+ *  PROFILE <samples> <bucketShift>
+ *  <first byte address of bucket [hex]> <count>   [one line per non-empty bucket]
+ *  END
+ */
+void dump(Print & print);
+
+} // namespace Profiler
+
+#endif // PROFILER_HPP
@@ -0,0 +1,107 @@
+#ifndef RINGARITHMETIC_HPP
+#define RINGARITHMETIC_HPP
+
+#include <stdint.h>
+
+/**
+ * Positions on a ring without division - on AVR a 16 bit division is a library call of a few hundred
+ * cycles, a 32 bit one and fmod() even more. Ring<modulus> masks for power of two moduli [branch-free]
+ * and multiplies by the reciprocal otherwise. Where a value is off by at most about one modulus, as
+ * when stepping along the ring, wrapOnce() and symmetrizeOnce() get along with a conditional
+ * subtraction, take the modulus at runtime and work for doubles as well.
+ * The results equal those of NeoPixelPatterns::normalizePosition(), symmetrizePosition() and
+ * circlePosition() - for all int16_t values, see the static_asserts in NeoPixelPatterns.cpp.
+ */
+namespace RingArithmetic
+{
+
+// [-modulus, 2 * modulus) -> [0, modulus) - for signed types.
+template<typename T>
+constexpr T wrapOnce(T const value, T const modulus)
+{
+    return (0 > value) ? (value + modulus) : ((modulus <= value) ? (value - modulus) : value);
+}
+
+// [-modulus, modulus) -> [modulus/2 - modulus, modulus/2) - like symmetrizePosition(), which for doubles
+// rounds value + modulus and the way back the same way, so the renderers stay bit-exact.
+template<typename T>
+constexpr T symmetrizeOnce(T const value, T const modulus)
+{
+    T const shifted = value + modulus;
+    T const normalized = (modulus <= shifted) ? (shifted - modulus) : shifted;
+    return (modulus / 2 > normalized) ? normalized : (normalized - modulus);
+}
+
+constexpr uint8_t bitLength(uint16_t const value)
+{
+    return (0 == value) ? 0 : (1 + bitLength(value >> 1));
+}
+
+template<uint16_t modulus>
+struct Ring
+{
+    static_assert((0 < modulus) && (INT16_MAX >= modulus), "Positions are int16_t.");
+
+    static bool constexpr powerOfTwo = (0 == (modulus & (modulus - 1)));
+    static uint16_t constexpr mask = modulus - 1;
+    static uint16_t constexpr half = modulus / 2;
+
+    // floor(u * reciprocal / 2^shift) == u / modulus for u in [0, 2^15]: the error of the reciprocal
+    // is below 2^shift / modulus / 2^shift per unit of u, u * modulus < 2^shift keeps it below 1 / modulus.
+    // u * reciprocal stays below 2^32.
+    static uint8_t constexpr shift = 16 + bitLength(modulus - 1);
+    static uint32_t constexpr reciprocal = (static_cast<uint32_t>(1) << shift) / modulus + 1;
+
+    // [0, modulus) for any value.
+    static constexpr uint16_t normalize(int16_t const value)
+    {
+        return powerOfTwo ? (static_cast<uint16_t>(value) & mask) : normalizeByReciprocal(value);
+    }
+
+    // [half - modulus, half) for any value - 0 stays 0.
+    static constexpr int16_t symmetrize(int16_t const value)
+    {
+        return powerOfTwo ? static_cast<int16_t>(((static_cast<uint16_t>(value) + half) & mask) - half)
+                          : symmetrizeNormalized(normalizeByReciprocal(value));
+    }
+
+    // Back and forth over [0, half] once per modulus - like circlePosition(value, modulus / 2) for even moduli.
+    static constexpr int16_t circle(int16_t const value)
+    {
+        return circleNormalized(normalize(value));
+    }
+
+private:
+    static constexpr uint16_t remainder(uint16_t const value)
+    {
+        return value - static_cast<uint16_t>((static_cast<uint32_t>(value) * reciprocal) >> shift) * modulus;
+    }
+
+    static constexpr uint16_t normalizeByReciprocal(int16_t const value)
+    {
+        // |value| <= 2^15 - the remainder of a negative value counts back from modulus.
+        return (0 <= value) ? remainder(value) : complement(remainder(static_cast<uint16_t>(0U - static_cast<uint16_t>(value))));
+    }
+
+    static constexpr uint16_t complement(uint16_t const remainder)
+    {
+        return (0 == remainder) ? 0 : (modulus - remainder);
+    }
+
+    static constexpr int16_t symmetrizeNormalized(uint16_t const normalized)
+    {
+        return (half > normalized) ? static_cast<int16_t>(normalized) : static_cast<int16_t>(normalized - modulus);
+    }
+
+    static constexpr int16_t circleNormalized(uint16_t const normalized)
+    {
+        // half - |normalized - half|, the absolute value via the sign mask.
+        int16_t const distance = static_cast<int16_t>(normalized) - static_cast<int16_t>(half);
+        int16_t const sign = distance >> 15;
+        return static_cast<int16_t>(half) - ((distance ^ sign) - sign);
+    }
+};
+
+} // namespace RingArithmetic
+
+#endif // RINGARITHMETIC_HPP
@@ -2,8 +2,26 @@
 Clock display using an DS3231 RTC and a NeoPixel RGBW ring.
 */
 
+#include "AmbientLight.hpp"
+#include "Animation.hpp"
+#include "ClockFace.hpp"
+#include "ClockScaling.hpp"
 #include "Colors.hpp"
+#include "CurrentLimiter.hpp"
+#include "Events.hpp"
+#include "FrameScheduler.hpp"
+#include "InterruptLatency.hpp"
+#include "Memory.hpp"
 #include "NeoPixelPatterns.hpp"
+#include "Profiler.hpp"
+#include "RingArithmetic.hpp"
+#include "RingOrientation.hpp"
+#include "SerialCommands.hpp"
+#include "Soak.hpp"
+#include "SoakPositions.hpp"
+#include "SubsecondCounter.hpp"
+#include "Trace.hpp"
+#include "Ws2812Usart.hpp"
 
 #include "ArduinoDrivers/ArduinoUno.hpp"
 #include "ArduinoDrivers/avrpinspecializations.hpp"
@@ -20,258 +38,38 @@ Clock display using an DS3231 RTC and a NeoPixel RGBW ring.
 #include <DS3231.h>
 #include <Wire.h>
 
-// Classes, structs and methods.
-
-enum class SelectableColor
-{
-    blue,
-    green,
-    red,
-    yellow,
-    white
-};
-
-SelectableColor nextSelectableColor(SelectableColor const selectableColor)
-{
-    SelectableColor color = SelectableColor::white;
-    switch (selectableColor)
-    {
-    case SelectableColor::blue:
-    {
-        color = SelectableColor::green;
-        break;
-    }
-    case SelectableColor::green:
-    {
-        color = SelectableColor::red;
-        break;
-    }
-    case SelectableColor::red:
-    {
-        color = SelectableColor::yellow;
-        break;
-    }
-    case SelectableColor::yellow:
-    {
-        color = SelectableColor::white;
-        break;
-    }
-    case SelectableColor::white:
-    {
-        color = SelectableColor::blue;
-        break;
-    }
-    }
-    return color;
-}
-
-SelectableColor previousSelectableColor(SelectableColor const selectableColor)
-{
-    SelectableColor color = SelectableColor::white;
-    switch (selectableColor)
-    {
-    case SelectableColor::blue:
-    {
-        color = SelectableColor::white;
-        break;
-    }
-    case SelectableColor::green:
-    {
-        color = SelectableColor::blue;
-        break;
-    }
-    case SelectableColor::red:
-    {
-        color = SelectableColor::green;
-        break;
-    }
-    case SelectableColor::yellow:
-    {
-        color = SelectableColor::red;
-        break;
-    }
-    case SelectableColor::white:
-    {
-        color = SelectableColor::yellow;
-        break;
-    }
-    }
-    return color;
-}
-
-Colors::Color_t colorFrom(SelectableColor const selectableColor)
-{
-    Colors::Color_t color = Colors::Black;
-    switch (selectableColor)
-    {
-    case SelectableColor::blue:
-    {
-        color = Colors::Blue;
-        break;
-    }
-    case SelectableColor::green:
-    {
-        color = Colors::Green;
-        break;
-    }
-    case SelectableColor::red:
-    {
-        color = Colors::Red;
-        break;
-    }
-    case SelectableColor::yellow:
-    {
-        color = Colors::Yellow;
-        break;
-    }
-    case SelectableColor::white:
-    {
-        color = Colors::White;
-        break;
-    }
-    }
-    return color;
-}
+#include <avr/pgmspace.h>
+#include <stddef.h>
 
+// Classes, structs and methods.
 
-enum class DisplayComponent
-{
-    hours,
-    minutes,
-    seconds
-};
-
-struct ColorSettings
+// Per display component: defaults used without a backup in EEPROM.
+struct DisplayComponentDefaults
 {
-    SelectableColor selectableColor = SelectableColor::white;
-    uint8_t brightness = 255;
-
-    Colors::Color_t scaledColor() const
-    {
-        return Colors::colorScaleBrightness(colorFrom(selectableColor), static_cast<double>(brightness) / 255.);
-    }
+    uint8_t hue;
+    ClockFace::SelectableKernel selectableKernel;
 };
 
-struct ColorsSettings
-{
-    ColorSettings colorsSettings[3];
-
-    ColorSettings & at(DisplayComponent const component)
-    {
-        ColorSettings * colorSettings = nullptr;
-        switch (component)
-        {
-        case DisplayComponent::hours:
-        {
-            colorSettings = &colorsSettings[0];
-            break;
-        }
-        case DisplayComponent::minutes:
-        {
-            colorSettings = &colorsSettings[1];
-            break;
-        }
-        case DisplayComponent::seconds:
-        {
-            colorSettings = &colorsSettings[2];
-            break;
-        }
-        }
-        return *colorSettings;
-    }
-
-    ColorSettings const & at(DisplayComponent const component) const
-    {
-        ColorSettings const * colorSettings = nullptr;
-        switch (component)
-        {
-        case DisplayComponent::hours:
-        {
-            colorSettings = &colorsSettings[0];
-            break;
-        }
-        case DisplayComponent::minutes:
-        {
-            colorSettings = &colorsSettings[1];
-            break;
-        }
-        case DisplayComponent::seconds:
-        {
-            colorSettings = &colorsSettings[2];
-            break;
-        }
-        }
-        return *colorSettings;
-    }
-
-    bool colorConflicts(SelectableColor const color) const
-    {
-        return ((color == at(DisplayComponent::hours).selectableColor)
-                || (color == at(DisplayComponent::minutes).selectableColor)
-                || (color == at(DisplayComponent::seconds).selectableColor));
-    }
+DisplayComponentDefaults const displayComponentDefaults[ClockFace::displayComponentCount] PROGMEM = {
+    {168, ClockFace::SelectableKernel::delta},             // hours: blue
+    {88, ClockFace::SelectableKernel::mountainNarrow},     // minutes: green
+    {0, ClockFace::SelectableKernel::mountainNarrow},      // seconds: red
 };
 
 
-struct TimeOfDay
-{
-    uint8_t hours;
-    uint8_t minutes;
-    uint8_t seconds;
-
-    TimeOfDay(uint8_t const hours = 0,
-              uint8_t const minutes = 0,
-              uint8_t const seconds = 0)
-        : hours(hours)
-        , minutes(minutes)
-        , seconds(seconds)
-    {
-        // intentinoally empty
-    }
-    TimeOfDay(const TimeOfDay &) = default;
-    TimeOfDay(TimeOfDay &&) = default;
-    TimeOfDay &operator=(const TimeOfDay &) = default;
-    TimeOfDay &operator=(TimeOfDay &&) = default;
-};
-
-static TimeOfDay getTimeOfDayFromRTC(DS3231 & rtc)
+static ClockFace::TimeOfDay getTimeOfDayFromRTC(DS3231 & rtc)
 {
     // Get hour, minute, and second.
     bool h12Flag = false;
     bool pmFlag = false;
-    TimeOfDay const timeOfDay(rtc.getHour(h12Flag, pmFlag),
+    ClockFace::TimeOfDay const timeOfDay(rtc.getHour(h12Flag, pmFlag),
                               rtc.getMinute(),
                               rtc.getSecond());
 
     return timeOfDay;
 }
 
-static void showTimeOfDay(Adafruit_NeoPixel & strip, TimeOfDay const & timeOfDay, double subseconds, ColorsSettings const & colorsSettings)
-{
-    double const secondsAndSubseconds = static_cast<double>(timeOfDay.seconds) + subseconds;
-
-    strip.clear();
-
-    uint16_t const pixelIndexHours = (timeOfDay.hours % 12) * strip.numPixels() / 12;
-    strip.setPixelColor(pixelIndexHours, Colors::addColors(colorsSettings.at(DisplayComponent::hours).scaledColor(),
-                                                           strip.getPixelColor(pixelIndexHours)));
-
-    double const pixelIndexMinutes = (static_cast<double>(timeOfDay.minutes) + (secondsAndSubseconds / 60.)) / 60. * strip.numPixels();
-    NeoPixelPatterns::addColorsWrapping(strip,
-                                        pixelIndexMinutes,
-                                        NeoPixelPatterns::brightnessFunctionMountain,
-                                        colorsSettings.at(DisplayComponent::minutes).scaledColor());
-
-    double const pixelIndexSeconds = secondsAndSubseconds / 60. * strip.numPixels();
-    NeoPixelPatterns::addColorsWrapping(strip,
-                                        pixelIndexSeconds,
-                                        NeoPixelPatterns::brightnessFunctionMountain,
-                                        colorsSettings.at(DisplayComponent::seconds).scaledColor());
-
-    strip.show();                          //  Update strip to match
-}
-
-static void serialPrintTimeOfDay(TimeOfDay const & timeOfDay)
+static void serialPrintTimeOfDay(ClockFace::TimeOfDay const & timeOfDay)
 {
     // send what's going on to the serial monitor.
     Serial.print(timeOfDay.hours, DEC);
@@ -298,6 +96,68 @@ static void serialPrintTimeOfDay(TimeOfDay const & timeOfDay)
     Serial.println();
 }
 
+// Timestamps of the startup sequence in micros() - i.e. since the Arduino core's init() right after reset
+// [the fuses' start-up delay and the C runtime initialization before that are not included].
+struct BootTiming
+{
+    unsigned long setupBegin = 0;
+    unsigned long settingsLoaded = 0;
+    unsigned long rtcReady = 0;
+    unsigned long setupEnd = 0;
+    unsigned long firstFrame = 0;
+};
+
+static void serialPrintBootTiming(BootTiming const & bootTiming)
+{
+    Serial.print("Boot [us] setup: ");
+    Serial.print(bootTiming.setupBegin, DEC);
+    Serial.print(" settings: ");
+    Serial.print(bootTiming.settingsLoaded, DEC);
+    Serial.print(" rtc: ");
+    Serial.print(bootTiming.rtcReady, DEC);
+    Serial.print(" setup done: ");
+    Serial.print(bootTiming.setupEnd, DEC);
+    Serial.print(" first frame: ");
+    Serial.print(bootTiming.firstFrame, DEC);
+    Serial.println();
+}
+
+// Poll for the RTC's acknowledge instead of assuming its worst case power-up time.
+static bool waitForRtc(uint8_t const address, unsigned long const timeoutMs)
+{
+    unsigned long const start = millis();
+    do
+    {
+        Wire.beginTransmission(address);
+        if (0 == Wire.endTransmission())
+        {
+            return true;
+        }
+    }
+    while ((millis() - start) < timeoutMs);
+    return false;
+}
+
+static void serialPrintCurrent(CurrentLimiter::Limiter const & limiter)
+{
+    Serial.print("Current [mA] peak: ");
+    Serial.print(limiter.peakMilliAmps(), DEC);
+    Serial.print(" average: ");
+    Serial.print(limiter.averageMilliAmps(), DEC);
+    Serial.println();
+}
+
+static void serialPrintMemory()
+{
+    Serial.print("SRAM [bytes] free: ");
+    Serial.print(Memory::currentFreeBytes(), DEC);
+    Serial.print(" minimum free: ");
+    Serial.print(Memory::minimumFreeBytes(), DEC);
+    Serial.print(" heap top: 0x");
+    Serial.print(Memory::heapTop(), HEX);
+    Serial.println();
+}
+
 template<class ButtonTimed_>
 static void serialPrintButton(char const * const name)
 {
@@ -325,36 +185,15 @@ static void serialPrintButton(char const * const name)
     }
 }
 
-enum class SettingsSelection
+// Values index settingsSelectionProperties.
+enum class SettingsSelection : uint8_t
 {
     hours,
     minutes,
     seconds
 };
 
-DisplayComponent displayComponentFrom(SettingsSelection const selection)
-{
-    DisplayComponent component = DisplayComponent::hours;
-    switch (selection)
-    {
-    case SettingsSelection::hours:
-    {
-        component = DisplayComponent::hours;
-        break;
-    }
-    case SettingsSelection::minutes:
-    {
-        component = DisplayComponent::minutes;
-        break;
-    }
-    case SettingsSelection::seconds:
-    {
-        component = DisplayComponent::seconds;
-        break;
-    }
-    }
-    return component;
-}
+uint8_t constexpr settingsSelectionCount = static_cast<uint8_t>(SettingsSelection::seconds) + 1;
 
 enum class SettingsType
 {
@@ -363,73 +202,41 @@ enum class SettingsType
     color
 };
 
+// Per settings selection: the display component and the member of TimeOfDay it modifies.
+struct SettingsSelectionProperties
+{
+    ClockFace::DisplayComponent component;
+    uint8_t timeOfDayOffset;
+    uint8_t wrapAround;
+};
+
+static_assert(__is_standard_layout(ClockFace::TimeOfDay), "TimeOfDay members are addressed by offsetof().");
+
+SettingsSelectionProperties const settingsSelectionProperties[settingsSelectionCount] PROGMEM = {
+    // The whole day - the RTC runs in 24h mode, PM hours are marked by a blinking hours hand.
+    {ClockFace::DisplayComponent::hours, offsetof(ClockFace::TimeOfDay, hours), 24},
+    {ClockFace::DisplayComponent::minutes, offsetof(ClockFace::TimeOfDay, minutes), 60},
+    {ClockFace::DisplayComponent::seconds, offsetof(ClockFace::TimeOfDay, seconds), 60},
+};
+
+ClockFace::DisplayComponent displayComponentFrom(SettingsSelection const selection)
+{
+    return static_cast<ClockFace::DisplayComponent>(pgm_read_byte(&settingsSelectionProperties[static_cast<uint8_t>(selection)].component));
+}
+
 SettingsSelection nextSettingsSelection(SettingsSelection const selection)
 {
-    SettingsSelection newSelection = SettingsSelection::seconds;
-    switch (selection)
-    {
-    case SettingsSelection::hours:
-    {
-        newSelection = SettingsSelection::minutes;
-        break;
-    }
-    case SettingsSelection::minutes:
-    {
-        newSelection = SettingsSelection::seconds;
-        break;
-    }
-    case SettingsSelection::seconds:
-    {
-        newSelection = SettingsSelection::hours;
-        break;
-    }
-    }
-    return newSelection;
+    return static_cast<SettingsSelection>((static_cast<uint8_t>(selection) + 1) % settingsSelectionCount);
 }
 
-uint8_t * timeOfDayComponentForSelection(TimeOfDay & timeOfDay, SettingsSelection const selection)
+uint8_t * timeOfDayComponentForSelection(ClockFace::TimeOfDay & timeOfDay, SettingsSelection const selection)
 {
-    uint8_t * newSelection = nullptr;
-    switch (selection)
-    {
-    case SettingsSelection::hours:
-    {
-        newSelection = &timeOfDay.hours;
-        break;
-    }
-    case SettingsSelection::minutes:
-    {
-        newSelection = &timeOfDay.minutes;
-        break;
-    }
-    case SettingsSelection::seconds:
-    {
-        newSelection = &timeOfDay.seconds;
-        break;
-    }
-    }
-    return newSelection;
+    return reinterpret_cast<uint8_t *>(&timeOfDay) + pgm_read_byte(&settingsSelectionProperties[static_cast<uint8_t>(selection)].timeOfDayOffset);
 }
 
 uint8_t timeOfDayComponentWrapAroundForSelection(SettingsSelection const selection)
 {
-    uint8_t wrapAround = 255;
-    switch (selection)
-    {
-    case SettingsSelection::hours:
-    {
-        wrapAround = 12;
-        break;
-    }
-    case SettingsSelection::minutes:
-        [[fallthrough]];
-    case SettingsSelection::seconds:
-    {
-        wrapAround = 60;
-        break;
-    }
-    }
-    return wrapAround;
+    return pgm_read_byte(&settingsSelectionProperties[static_cast<uint8_t>(selection)].wrapAround);
 }
 
 
@@ -443,45 +250,46 @@ uint8_t incrementUint8Capped(uint8_t const value)
     return newValue;
 }
 
-bool longPressDurationActive(uint8_t const longPressDuration)
+// Long press durations [in cycles] at which a held button repeats - the steps get closer to ramp up the speed.
+// From the end of the list on it repeats every cycle.
+uint8_t constexpr longPressRepeatSteps[] = {0, 5, 10, 14, 18, 21, 24, 27, 29, 31, 33, 35, 37};
+uint8_t constexpr longPressRepeatStepCount = sizeof(longPressRepeatSteps) / sizeof(longPressRepeatSteps[0]);
+uint8_t constexpr longPressRepeatAlways = longPressRepeatSteps[longPressRepeatStepCount - 1];
+
+constexpr uint8_t longPressRepeatBitmapByte(uint8_t const byteIndex)
 {
-    // ramp up selection speed by decreasing the difference between true-returns.
-    switch (longPressDuration)
-    {
-    case 0:
-        // fall through
-    case 5:
-        // fall through
-    case 10:
-        // fall through
-    case 14:
-        // fall through
-    case 18:
-        // fall through
-    case 21:
-        // fall through
-    case 24:
-        // fall through
-    case 27:
-        // fall through
-    case 29:
-        // fall through
-    case 31:
-        // fall through
-    case 33:
-        // fall through
-    case 35:
+    uint8_t byte = 0;
+    for (uint8_t i = 0; i < longPressRepeatStepCount; ++i)
     {
-        return true;
+        if ((longPressRepeatSteps[i] >> 3) == byteIndex)
+        {
+            byte |= (1 << (longPressRepeatSteps[i] & 0x07));
+        }
     }
-    default:
+    return byte;
+}
+
+// One bit per duration below longPressRepeatAlways.
+uint8_t const longPressRepeatBitmap[] PROGMEM = {
+    longPressRepeatBitmapByte(0),
+    longPressRepeatBitmapByte(1),
+    longPressRepeatBitmapByte(2),
+    longPressRepeatBitmapByte(3),
+    longPressRepeatBitmapByte(4),
+};
+
+static_assert(longPressRepeatAlways <= 8 * sizeof(longPressRepeatBitmap), "longPressRepeatBitmap too short.");
+
+bool longPressDurationActive(uint8_t const longPressDuration)
+{
+    if (longPressRepeatAlways <= longPressDuration)
     {
-        return (37 <= longPressDuration);
-    }
+        return true;
     }
+    return (0 != (pgm_read_byte(&longPressRepeatBitmap[longPressDuration >> 3]) & (1 << (longPressDuration & 0x07))));
 }
 
-static void incrementTimeOfDayComponent(TimeOfDay & timeOfDay, SettingsSelection const settingsSelection)
+static void incrementTimeOfDayComponent(ClockFace::TimeOfDay & timeOfDay, SettingsSelection const settingsSelection)
 {
     uint8_t * const component = timeOfDayComponentForSelection(timeOfDay, settingsSelection);
     uint8_t const wrapAround = timeOfDayComponentWrapAroundForSelection(settingsSelection);
@@ -492,7 +300,7 @@ static void incrementTimeOfDayComponent(TimeOfDay & timeOfDay, SettingsSelection
     }
 }
 
-static void decrementTimeOfDayComponent(TimeOfDay & timeOfDay, SettingsSelection const settingsSelection)
+static void decrementTimeOfDayComponent(ClockFace::TimeOfDay & timeOfDay, SettingsSelection const settingsSelection)
 {
     uint8_t * const component = timeOfDayComponentForSelection(timeOfDay, settingsSelection);
     uint8_t const wrapAround = timeOfDayComponentWrapAroundForSelection(settingsSelection);
@@ -504,12 +312,21 @@ static void decrementTimeOfDayComponent(TimeOfDay & timeOfDay, SettingsSelection
 }
 
 
+// Increment whenever the meaning of the stored bytes changes - older backups are ignored then.
+uint8_t constexpr backupValuesLayout = 4;
+
 struct BackupValues
 {
-    ColorsSettings colorsSettings;
+    uint8_t layout = backupValuesLayout;
+    ClockFace::ColorsSettings colorsSettings;
+    uint16_t currentBudgetMilliAmps;
+    uint8_t ringOffsets[ClockFace::maximumRingCount] = {};
+    ClockFace::TrailSettings trailSettings;
 
-    BackupValues(ColorsSettings const & colorsSettings)
+    BackupValues(ClockFace::ColorsSettings const & colorsSettings, uint16_t const currentBudgetMilliAmps, ClockFace::TrailSettings const & trailSettings)
         : colorsSettings(colorsSettings)
+        , currentBudgetMilliAmps(currentBudgetMilliAmps)
+        , trailSettings(trailSettings)
     {
         // intentionally empty
     }
@@ -518,67 +335,335 @@ struct BackupValues
 static Eeprom::Address constexpr backupValuesAddress = 0;
 static_assert(Eeprom::fitsInEeprom<BackupValues, backupValuesAddress>());
 
+// Fixed address, so the event list survives changes of BackupValues.
+static Eeprom::Address constexpr eventListAddress = 64;
+static_assert(backupValuesAddress + sizeof(BackupValues) + 2 /* CRC */ <= eventListAddress, "BackupValues overlaps the event list.");
+static_assert(Eeprom::fitsInEeprom<Events::EventList, eventListAddress>());
+
 
 // Static variables and instances.
 
+// An inner 12 LEDs ring for the hours and an outer 60 LEDs ring for minutes and seconds.
+#define DUAL_RING false
+// Drive the outer ring from its own pin instead of chaining it to the inner ring's data output.
+#define DUAL_RING_TWO_PINS false
+
+#if DUAL_RING_TWO_PINS && !DUAL_RING
+#error "Two pins are for two rings."
+#endif
+
 namespace Pins
 {
-int constexpr led = 3;
+int constexpr led = 3; // with LED_OUTPUT_USART_SPI the LEDs are driven from TXD0 [D1] instead
+int constexpr ledOuterRing = 6; // DUAL_RING_TWO_PINS - not D4, which is XCK0 with LED_OUTPUT_USART_SPI
 }
 
-uint16_t constexpr ledCount = 12;
+#if DUAL_RING
+// The inner ring comes first in the chain.
+ClockFace::RingLayout constexpr ringLayout{{{0, 12}, {12, 60}}, 2, {0, 1, 1}};
+uint8_t const ringPixelCounts[] = {12, 60};
+#else
+ClockFace::RingLayout constexpr ringLayout = ClockFace::singleRingLayout(12);
+uint8_t const ringPixelCounts[] = {12};
+#endif
+uint8_t constexpr ringCount = ringLayout.ringCount;
+uint16_t constexpr ledCount = ringLayout.pixelCount();
+uint8_t constexpr ledBytesPerPixel = 3; // NEO_GRB
+// How the rings are mounted: direction of their pixel indices and the default index of their 12 o'clock pixel.
+RingOrientation::Direction constexpr ringDirection = RingOrientation::Direction::clockwise;
+uint8_t constexpr defaultRingOffset = 0;
+typedef RingOrientation::IndexMap<ringCount, ledCount, ringDirection> RingIndexMap;
+
+// The seconds hand's trail lives on its ring.
+uint8_t constexpr trailRing = ringLayout.handRings[static_cast<uint8_t>(ClockFace::DisplayComponent::seconds)];
+uint16_t constexpr trailPixelCount = ringLayout.rings[trailRing].pixelCount;
+
+// Ring carrying the hand of the selected component - the one whose orientation is modified.
+uint8_t ringOfSelection(SettingsSelection const selection)
+{
+    return ringLayout.handRings[static_cast<uint8_t>(displayComponentFrom(selection))];
+}
 uint8_t constexpr defaultMaxBrightness = 200;
+// Supply limit for the LEDs, e.g. an USB port with some margin for the rest of the circuit.
+uint16_t constexpr defaultCurrentBudgetMilliAmps = 400;
 
 #define PRINT_SERIAL_TIME false
 #define PRINT_SERIAL_BUTTONS false
+#define PRINT_SERIAL_CURRENT false
+#define PRINT_SERIAL_LATENCY false
+#define PRINT_SERIAL_BOOT_TIMING false
+// Sample where the time goes [Timer2] and print the histogram periodically - see tools/profile.py.
+#define PRINT_SERIAL_PROFILE false
+// Free SRAM now and the minimum since boot [see Memory.hpp].
+#define PRINT_SERIAL_MEMORY false
+// Average rendered frames per second.
+#define PRINT_SERIAL_FPS false
+
+// Measure the worst-case interrupt latency [Timer2] and keep the maximum of this run in EEPROM.
+// So it can also be measured in builds without Serial and printed by the next PRINT_SERIAL_LATENCY run.
+#define MEASURE_INTERRUPT_LATENCY PRINT_SERIAL_LATENCY
+
+// Take the subseconds from the DS3231's 32K output counted by Timer1 [on D5] instead of simulating them via millis().
+#define SUBSECONDS_FROM_RTC_32KHZ false
+
+// Send the frame via USART0 in SPI mode with interrupts enabled instead of bit-banging with them disabled.
+#define LED_OUTPUT_USART_SPI false
+
+#if LED_OUTPUT_USART_SPI && DUAL_RING_TWO_PINS
+#error "USART0 drives a single data line - chain the rings instead."
+#endif
 
-DS3231 myRTC;
+#if LED_OUTPUT_USART_SPI && (PRINT_SERIAL_TIME || PRINT_SERIAL_BUTTONS || PRINT_SERIAL_CURRENT || PRINT_SERIAL_LATENCY || PRINT_SERIAL_BOOT_TIMING || PRINT_SERIAL_PROFILE || PRINT_SERIAL_MEMORY || PRINT_SERIAL_FPS)
+#error "USART0 can either drive the LEDs or be used for Serial."
+#endif
 
-// Declare our NeoPixel strip object:
-// Adafruit_NeoPixel strip(ledCount, Pins::led, NEO_GRBW + NEO_KHZ800); // testing strip
-Adafruit_NeoPixel strip(ledCount, Pins::led, NEO_GRB + NEO_KHZ800); // 12-LEDs ring
-// Argument 1 = Number of pixels in NeoPixel strip
-// Argument 2 = Arduino pin number (most are valid)
-// Argument 3 = Pixel type flags, add together as needed:
-//   NEO_KHZ800  800 KHz bitstream (most NeoPixel products w/WS2812 LEDs)
-//   NEO_KHZ400  400 KHz (classic 'v1' (not v2) FLORA pixels, WS2811 drivers)
-//   NEO_GRB     Pixels are wired for GRB bitstream (most NeoPixel products)
-//   NEO_RGB     Pixels are wired for RGB bitstream (v1 FLORA pixels, not v2)
-//   NEO_RGBW    Pixels are wired for RGBW bitstream (NeoPixel RGBW products)
+// Record the inputs of every frame to Serial / replay recorded inputs from Serial [see Trace.hpp].
+#define TRACE_RECORD false
+// The host replay [tools/replay] sets it on the command line.
+#ifndef TRACE_REPLAY
+#define TRACE_REPLAY false
+#endif
 
+#if (TRACE_RECORD || TRACE_REPLAY) && (LED_OUTPUT_USART_SPI || PRINT_SERIAL_TIME || PRINT_SERIAL_BUTTONS || PRINT_SERIAL_CURRENT || PRINT_SERIAL_LATENCY || PRINT_SERIAL_BOOT_TIMING || PRINT_SERIAL_PROFILE || PRINT_SERIAL_MEMORY || PRINT_SERIAL_FPS)
+#error "Traces use Serial exclusively."
+#endif
 
-uint8_t constexpr cycleDurationMs = 50;
-uint8_t constexpr shortPressCount = 2;
-uint8_t constexpr longPressCount = 10;
+#if TRACE_RECORD && TRACE_REPLAY
+#error "Either record or replay."
+#endif
 
-typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D11, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonTop;
-typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D8, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonRight;
-typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D9, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonBottom;
-typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D10, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonLeft;
+#if (TRACE_RECORD || TRACE_REPLAY) && SUBSECONDS_FROM_RTC_32KHZ
+#error "The Timer1 subsecond counter is not part of traces."
+#endif
 
+// Run on simulated time as fast as possible and check the render times and the hands [see Soak.hpp].
+// The host soak [tools/soak] builds this file with it set on the command line.
+#ifndef SOAK_RUN
+#define SOAK_RUN false
+#endif
 
-template <uint8_t index>
-class Buttons;
+#if SOAK_RUN && (TRACE_RECORD || TRACE_REPLAY || LED_OUTPUT_USART_SPI || SUBSECONDS_FROM_RTC_32KHZ)
+#error "Soak runs simulate the RTC and report via Serial."
+#endif
 
-template <> class Buttons<0> : public ButtonTop {/* intentionally empty */};
-template <> class Buttons<1> : public ButtonRight {/* intentionally empty */};
-template <> class Buttons<2> : public ButtonBottom {/* intentionally empty */};
-template <> class Buttons<3> : public ButtonLeft {/* intentionally empty */};
+// Program the DS3231's alarms with the next event and an hourly chime - their INT/SQW output has to be wired to D2.
+#define EVENTS_FROM_RTC_ALARMS false
 
-typedef AvrPinOutput<ArduinoUno::A0::Register, ArduinoUno::A0::pinNumber> PinPowerRtc;
+#if EVENTS_FROM_RTC_ALARMS && (TRACE_REPLAY || SOAK_RUN)
+#error "Simulated time does not drive the RTC's alarms."
+#endif
 
+#if EVENTS_FROM_RTC_ALARMS
+uint16_t constexpr alarmFlashDurationMs = 1000;
+uint8_t constexpr chimeFlashCount = 1;
+uint8_t constexpr wakeFlashCount = 30;
+// The current limiter dims the whole frame to this budget at night.
+uint16_t constexpr nightCurrentBudgetMilliAmps = 30;
 
-// Wrappers for loops.
-template<uint8_t Index>
-struct WrapperInitialize
-{
-    static void impl()
-    {
-        Buttons<Index>::initialize();
-    }
-};
+static Events::EventList eventList;
+static Events::Scheduler eventScheduler;
+#endif
 
-template<uint8_t Index>
+// Scale the whole frame with the ambient light measured by a light dependent resistor on A1 [see AmbientLight.hpp].
+#define AMBIENT_LIGHT_BRIGHTNESS false
+
+#if AMBIENT_LIGHT_BRIGHTNESS && (TRACE_RECORD || TRACE_REPLAY || SOAK_RUN)
+#error "The ambient light is not part of traces and soak runs."
+#endif
+
+// Idle between the loop() cycles at 1 MHz in the idle sleep mode instead of busy waiting at 8 MHz [see ClockScaling.hpp].
+#define IDLE_AT_REDUCED_CLOCK false
+// Time spent at the reduced clock and the estimated energy saved by it.
+#define PRINT_SERIAL_ENERGY false
+
+#if IDLE_AT_REDUCED_CLOCK && (MEASURE_INTERRUPT_LATENCY || PRINT_SERIAL_PROFILE)
+#error "Timer2 would run at an eighth of its rate while idling."
+#endif
+
+#if PRINT_SERIAL_ENERGY && !IDLE_AT_REDUCED_CLOCK
+#error "Only idling at the reduced clock is measured."
+#endif
+
+#if PRINT_SERIAL_ENERGY && LED_OUTPUT_USART_SPI
+#error "USART0 can either drive the LEDs or be used for Serial."
+#endif
+
+#if PRINT_SERIAL_ENERGY
+unsigned long constexpr energyReportIntervalMs = 60000;
+// ATmega328P at 5 V, typical supply currents from the datasheet's plots: active at 8 MHz [busy waiting
+// in delay()] and idle sleep mode at 1 MHz.
+uint16_t constexpr activeFullClockMicroAmps = 5000;
+uint16_t constexpr idleSlowClockMicroAmps = 250;
+
+static unsigned long lastEnergyReportTime = 0;
+#endif
+
+// Set the time and the hands via Serial, dump the settings and read telemetry [see SerialCommands.hpp and tools/configure.py].
+#define SERIAL_COMMANDS false
+
+#if SERIAL_COMMANDS && (LED_OUTPUT_USART_SPI || TRACE_RECORD || TRACE_REPLAY || SOAK_RUN)
+#error "Serial commands need Serial and the RTC."
+#endif
+
+#if SERIAL_COMMANDS && IDLE_AT_REDUCED_CLOCK
+#error "The USART does not receive at the reduced clock."
+#endif
+
+#if SERIAL_COMMANDS
+// Parsing is spread over the cycles - the host waits for each answer, so the RX buffer never fills up.
+uint8_t constexpr serialCommandBytesPerCycle = 16;
+// Settings changed by commands are stored once no command came for this long - a script of many
+// commands costs a single EEPROM update instead of stalling the loop on every line.
+uint16_t constexpr serialSettingsStoreDelayMs = 2000;
+
+static SerialCommands::Parser serialCommandParser;
+static bool serialSettingsChanged = false;
+static unsigned long serialSettingsChangedMillis = 0;
+#endif
+
+#if AMBIENT_LIGHT_BRIGHTNESS
+// Fade between the brightness steps instead of jumping.
+uint16_t constexpr ambientTransitionDurationMs = 1000;
+
+static AmbientLight::Dimmer ambientDimmer;
+#endif
+
+#if SOAK_RUN
+// Simulated time per loop() cycle, the simulated RTC starts shortly before midnight so all wrap-arounds come early.
+unsigned long constexpr soakStepMs = 100;
+unsigned long constexpr soakStartMs = (23UL * 3600 + 59 * 60) * 1000;
+#ifndef SOAK_DURATION_HOURS
+#define SOAK_DURATION_HOURS 25
+#endif
+unsigned long constexpr soakDurationMs = SOAK_DURATION_HOURS * 3600UL * 1000;
+unsigned long constexpr soakReportIntervalMs = 3600UL * 1000;
+
+// Simulated millis() - it drives the simulated RTC, too.
+static unsigned long soakMillis = 0;
+static unsigned long lastSoakReportTime = 0;
+static Soak::Monitor soakMonitor;
+static Soak::PositionMonitor<ClockFace::clockHandCount> soakPositionMonitor;
+#endif
+
+#if PRINT_SERIAL_LATENCY && !MEASURE_INTERRUPT_LATENCY
+#error "Printing the interrupt latency requires measuring it."
+#endif
+
+#if PRINT_SERIAL_PROFILE && MEASURE_INTERRUPT_LATENCY
+#error "Profiler and interrupt latency measurement both need Timer2."
+#endif
+
+#if PRINT_SERIAL_PROFILE
+unsigned long constexpr profileDumpIntervalMs = 10000;
+#endif
+
+#if PRINT_SERIAL_FPS
+unsigned long constexpr fpsReportIntervalMs = 10000;
+#endif
+
+// Behind everything else at the end of the EEPROM.
+static Eeprom::Address constexpr interruptLatencyAddress = E2END + 1 - sizeof(uint16_t) - 2 /* CRC */;
+static_assert(Eeprom::fitsInEeprom<uint16_t, interruptLatencyAddress>());
+
+DS3231 myRTC;
+uint8_t constexpr rtcI2cAddress = 0x68;
+// DS3231 datasheet: the I2C interface is available at most 250 ms [tREC] after VCC is applied.
+unsigned long constexpr rtcPowerUpTimeoutMs = 300;
+
+// Declare our NeoPixel strip object:
+// Adafruit_NeoPixel strip(ledCount, Pins::led, NEO_GRBW + NEO_KHZ800); // testing strip
+Adafruit_NeoPixel strip(ledCount, Pins::led, NEO_GRB + NEO_KHZ800); // 12-LEDs ring [and the 60-LEDs ring]
+// All rendering happens in strip in logical order [pixel 0 of each ring at 12 o'clock, clockwise] -
+// showStrip() copies it to physicalStrip through the rings' index map and sends that.
+#if DUAL_RING_TWO_PINS
+Adafruit_NeoPixel physicalStrip(ringLayout.rings[0].pixelCount, Pins::led, NEO_GRB + NEO_KHZ800);
+Adafruit_NeoPixel physicalStripOuterRing(ringLayout.rings[1].pixelCount, Pins::ledOuterRing, NEO_GRB + NEO_KHZ800);
+#else
+Adafruit_NeoPixel physicalStrip(ledCount, Pins::led, NEO_GRB + NEO_KHZ800);
+#endif
+// Argument 1 = Number of pixels in NeoPixel strip
+// Argument 2 = Arduino pin number (most are valid)
+// Argument 3 = Pixel type flags, add together as needed:
+//   NEO_KHZ800  800 KHz bitstream (most NeoPixel products w/WS2812 LEDs)
+//   NEO_KHZ400  400 KHz (classic 'v1' (not v2) FLORA pixels, WS2811 drivers)
+//   NEO_GRB     Pixels are wired for GRB bitstream (most NeoPixel products)
+//   NEO_RGB     Pixels are wired for RGB bitstream (v1 FLORA pixels, not v2)
+//   NEO_RGBW    Pixels are wired for RGBW bitstream (NeoPixel RGBW products)
+
+
+uint8_t constexpr cycleDurationMs = 50;
+// Longest time without a frame, even if nothing moves visibly.
+uint16_t constexpr maximumFrameIntervalMs = 1000;
+uint16_t constexpr modeTransitionDurationMs = 400;
+uint16_t constexpr valueTransitionDurationMs = 150;
+uint16_t constexpr pmBlinkHalfPeriodMs = 500;
+uint8_t constexpr shortPressCount = 2;
+uint8_t constexpr longPressCount = 10;
+
+#if TRACE_REPLAY
+typedef ButtonTimed<Button<Trace::ReplayPin<0>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonTop;
+typedef ButtonTimed<Button<Trace::ReplayPin<1>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonRight;
+typedef ButtonTimed<Button<Trace::ReplayPin<2>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonBottom;
+typedef ButtonTimed<Button<Trace::ReplayPin<3>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonLeft;
+#else
+typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D11, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonTop;
+typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D8, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonRight;
+typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D9, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonBottom;
+typedef ButtonTimed<Button<SimplePinAvrRead<ArduinoUno::D10, AvrInputOutput::InputPullup>, SimplePin::State::Zero>, shortPressCount, longPressCount> ButtonLeft;
+#endif
+
+
+template <uint8_t index>
+class Buttons;
+
+template <> class Buttons<0> : public ButtonTop {/* intentionally empty */};
+template <> class Buttons<1> : public ButtonRight {/* intentionally empty */};
+template <> class Buttons<2> : public ButtonBottom {/* intentionally empty */};
+template <> class Buttons<3> : public ButtonLeft {/* intentionally empty */};
+
+typedef AvrPinOutput<ArduinoUno::A0::Register, ArduinoUno::A0::pinNumber> PinPowerRtc;
+
+
+// Read the time of day from the RTC - or from the trace when replaying.
+static ClockFace::TimeOfDay readTimeOfDay()
+{
+#if SOAK_RUN
+    unsigned long const secondsOfDay = (soakStartMs + soakMillis) / 1000 % (24UL * 3600);
+    return ClockFace::TimeOfDay(secondsOfDay / 3600, secondsOfDay / 60 % 60, secondsOfDay % 60);
+#elif TRACE_REPLAY
+    return ClockFace::TimeOfDay(Trace::player.hours(), Trace::player.minutes(), Trace::player.seconds());
+#else
+    ClockFace::TimeOfDay const timeOfDay = getTimeOfDayFromRTC(myRTC);
+#if TRACE_RECORD
+    Trace::recorder.setTime(timeOfDay.hours, timeOfDay.minutes, timeOfDay.seconds);
+#endif
+    return timeOfDay;
+#endif
+}
+
+#if EVENTS_FROM_RTC_ALARMS
+// Without a list in EEPROM: night from 22:30 to 6:30 and the hourly chime.
+static void setDefaultEventList(Events::EventList & eventList)
+{
+    eventList = Events::EventList();
+    eventList.hourlyChime = true;
+    eventList.insert(Events::Event{6, 30, Events::EventType::nightEnd});
+    eventList.insert(Events::Event{22, 30, Events::EventType::nightStart});
+}
+#endif
+
+
+// Wrappers for loops.
+template<uint8_t Index>
+struct WrapperInitialize
+{
+    static void impl()
+    {
+        Buttons<Index>::initialize();
+    }
+};
+
+template<uint8_t Index>
 struct WrapperUpdate
 {
     static void impl()
@@ -599,6 +684,18 @@ struct WrapperCountIsDown
     }
 };
 
+template<uint8_t Index>
+struct WrapperCollectIsDown
+{
+    static void impl(uint8_t & buttonsDown)
+    {
+        if (Buttons<Index>::isDown())
+        {
+            buttonsDown |= (1 << Index);
+        }
+    }
+};
+
 uint8_t getButtonsAreDown()
 {
     uint8_t count = 0;
@@ -620,7 +717,11 @@ private:
     static uint8_t constexpr previousSecondsInvalid = 255;
 
     uint8_t previousSeconds = previousSecondsInvalid;
+#if SUBSECONDS_FROM_RTC_32KHZ
+    SubsecondCounter::SecondPhase secondPhase;
+#else
     unsigned long lastSecondChangeTime = 0;
+#endif
 
     bool modeChangeButtonWasUpOnceInThisMode = true;
 };
@@ -632,6 +733,10 @@ private:
     friend class StateModifyValue;
     friend class StateModifyBrightness;
     friend class StateModifyColor;
+    friend class StateModifyKernel;
+    friend class StateModifyOrientation;
+    friend class StateModifyTrailLength;
+    friend class StateModifyTrailColor;
 
     SettingsSelection settingsSelection = SettingsSelection::hours;
     uint8_t longPressDurationAccumulation = 0;
@@ -651,10 +756,29 @@ private:
 
 struct DataClock
 {
-    TimeOfDay timeOfDay;
+    ClockFace::TimeOfDay timeOfDay;
     double subseconds = 0;
-    ColorsSettings colorsSettings;
+    ClockFace::ColorsSettings colorsSettings;
     bool updateDisplay = false;
+    // Set by states whose frames change only with the motion of the hands - loop() skips frames which would not differ then.
+    bool frameScheduled = false;
+    // millis() at the beginning of the frame - all time dependent code uses this, so that frames are reproducible.
+    unsigned long frameMillis = 0;
+    // Set by the states while PM hours are set - the hours hand blinks then.
+    bool markPm = false;
+    uint16_t currentBudgetMilliAmps = defaultCurrentBudgetMilliAmps;
+#if EVENTS_FROM_RTC_ALARMS
+    bool nightMode = false;
+    uint8_t alarmFlashesRemaining = 0;
+#endif
+    RingIndexMap ringIndexMap{ringPixelCounts, defaultRingOffset};
+
+    // Crossfade from the last shown frame - started by the states, applied in loop().
+    Animation::Crossfade<ledCount> transition;
+
+    ClockFace::TrailSettings trailSettings;
+    // Updated by the states, added to the frame in loop().
+    Animation::Trail<trailPixelCount> trail;
 
     SettingsClockDisplay settingsClockDisplay;
     SettingsClockSettings settingsClockSettings;
@@ -672,9 +796,17 @@ public:
     void init(DataClock & data) const override
     {
         data.settingsClockDisplay.previousSeconds = data.settingsClockDisplay.previousSecondsInvalid;
+#if SUBSECONDS_FROM_RTC_32KHZ
+        data.settingsClockDisplay.secondPhase.reset();
+#else
         data.settingsClockDisplay.lastSecondChangeTime = 0;
+#endif
 
         data.settingsClockDisplay.modeChangeButtonWasUpOnceInThisMode = false;
+
+        data.trail.clear();
+
+        data.transition.start(strip, data.frameMillis, modeTransitionDurationMs);
     }
 
     AbstractState const & process(DataClock & data) const override;
@@ -709,6 +841,12 @@ protected:
     {
         return data.settingsClockSettings.settingsModify;
     }
+
+    // Smoothen discrete jumps of the modified values.
+    static void startValueTransition(DataClock & data)
+    {
+        data.transition.start(strip, data.frameMillis, valueTransitionDurationMs, Animation::Easing::easeOut);
+    }
 };
 static StateClockSettings stateClockSettings;
 
@@ -770,61 +908,594 @@ public:
 static StateModifyColor stateModifyColor;
 
 
+class StateModifyKernel : public StateClockSettings
+{
+public:
+
+    void init(DataClock & data) const override
+    {
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+
+    AbstractState const & process(DataClock & data) const override;
+
+    void deinit(DataClock & data) const override
+    {
+        // intentionally empty
+    }
+};
+static StateModifyKernel stateModifyKernel;
+
+
+class StateModifyOrientation : public StateClockSettings
+{
+public:
+
+    void init(DataClock & data) const override
+    {
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+
+    AbstractState const & process(DataClock & data) const override;
+
+    void deinit(DataClock & data) const override
+    {
+        // intentionally empty
+    }
+};
+static StateModifyOrientation stateModifyOrientation;
+
+
+class StateModifyTrailLength : public StateClockSettings
+{
+public:
+
+    void init(DataClock & data) const override
+    {
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+
+    AbstractState const & process(DataClock & data) const override;
+
+    void deinit(DataClock & data) const override
+    {
+        data.trail.clear();
+    }
+};
+static StateModifyTrailLength stateModifyTrailLength;
+
+
+class StateModifyTrailColor : public StateClockSettings
+{
+public:
+
+    void init(DataClock & data) const override
+    {
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+
+    AbstractState const & process(DataClock & data) const override;
+
+    void deinit(DataClock & data) const override
+    {
+        data.trail.clear();
+    }
+};
+static StateModifyTrailColor stateModifyTrailColor;
+
+
 // Statemachine instance data.
 
 static DataClock dataClock;
 static Helpers::Statemachine<DataClock> statemachine(stateClockDisplay);
 
+static CurrentLimiter::Limiter currentLimiter;
+static FrameScheduler::Scheduler frameScheduler(cycleDurationMs, maximumFrameIntervalMs);
+
+#if PRINT_SERIAL_BOOT_TIMING
+static BootTiming bootTiming;
+#endif
+
+#if MEASURE_INTERRUPT_LATENCY
+static uint16_t previousRunInterruptLatencyMicros = 0;
+static uint16_t storedInterruptLatencyMicros = 0;
+#endif
+
+#if PRINT_SERIAL_PROFILE
+static unsigned long lastProfileDumpTime = 0;
+#endif
+
+#if PRINT_SERIAL_FPS
+static unsigned long lastFpsReportTime = 0;
+#endif
+
 
 // setup() and loop() functionality.
 
+// When leaving the settings [and for serial commands].
+static void storeBackupValues(DataClock const & data)
+{
+    BackupValues backupValues(data.colorsSettings, data.currentBudgetMilliAmps, data.trailSettings);
+    for (uint8_t r = 0; r < ringCount; ++r)
+    {
+        backupValues.ringOffsets[r] = data.ringIndexMap.getOffset(r);
+    }
+    Eeprom::writeWithCrc(&backupValues, sizeof(BackupValues), backupValuesAddress);
+}
+
+#if EVENTS_FROM_RTC_ALARMS
+// Whenever the time or the event list changed.
+static void rescheduleEvents(DataClock & data)
+{
+    uint16_t const minuteOfDay = Events::minuteOfDayFromRtc(myRTC);
+    eventScheduler.begin(myRTC, eventList, minuteOfDay);
+    data.nightMode = eventList.isNight(minuteOfDay);
+}
+#endif
+
+static void writeTimeOfDayToRtc(DataClock & data)
+{
+    myRTC.setSecond(data.timeOfDay.seconds);
+    myRTC.setMinute(data.timeOfDay.minutes);
+    // In 24h format - the RTC runs in 24h mode.
+    myRTC.setHour(data.timeOfDay.hours);
+    // myRTC.setDoW(7);
+    // myRTC.setDate(9);
+    // myRTC.setMonth(6);
+    // myRTC.setYear(24);
+#if EVENTS_FROM_RTC_ALARMS
+    // The next event depends on the new time.
+    rescheduleEvents(data);
+#endif
+}
+
+#if SERIAL_COMMANDS
+static void serialPrintColorSettings(uint8_t const index, ClockFace::ColorSettings const & colorSettings)
+{
+    Serial.print("C ");
+    Serial.print(index, DEC);
+    Serial.print(" ");
+    Serial.print(colorSettings.hueSaturation.hue, DEC);
+    Serial.print(" ");
+    Serial.print(colorSettings.hueSaturation.saturation, DEC);
+    Serial.println();
+    Serial.print("B ");
+    Serial.print(index, DEC);
+    Serial.print(" ");
+    Serial.print(colorSettings.brightness, DEC);
+    Serial.println();
+    Serial.print("K ");
+    Serial.print(index, DEC);
+    Serial.print(" ");
+    Serial.print(static_cast<uint8_t>(colorSettings.selectableKernel), DEC);
+    Serial.println();
+}
+
+// The BackupValues besides the hands.
+static void serialPrintBackupSettings(DataClock const & data)
+{
+    Serial.print("L ");
+    Serial.print(data.trailSettings.length, DEC);
+    Serial.print(" ");
+    Serial.print(data.trailSettings.hueSaturation.hue, DEC);
+    Serial.print(" ");
+    Serial.print(data.trailSettings.hueSaturation.saturation, DEC);
+    Serial.println();
+    for (uint8_t r = 0; r < ringCount; ++r)
+    {
+        Serial.print("O ");
+        Serial.print(r, DEC);
+        Serial.print(" ");
+        Serial.print(data.ringIndexMap.getOffset(r), DEC);
+        Serial.println();
+    }
+    Serial.print("M ");
+    Serial.print(data.currentBudgetMilliAmps, DEC);
+    Serial.println();
+}
+
+#if EVENTS_FROM_RTC_ALARMS
+static void serialPrintEventList()
+{
+    // Replaying the dump replaces the list.
+    Serial.println("E");
+    for (uint8_t i = 0; i < eventList.count; ++i)
+    {
+        Serial.print("A ");
+        Serial.print(eventList.events[i].hours, DEC);
+        Serial.print(" ");
+        Serial.print(eventList.events[i].minutes, DEC);
+        Serial.print(" ");
+        Serial.print(static_cast<uint8_t>(eventList.events[i].type), DEC);
+        Serial.println();
+    }
+    Serial.print("H ");
+    Serial.print(eventList.hourlyChime ? 1 : 0, DEC);
+    Serial.println();
+}
+
+static void storeEventList(DataClock & data)
+{
+    Eeprom::writeWithCrc(&eventList, sizeof(Events::EventList), eventListAddress);
+    rescheduleEvents(data);
+}
+#endif
+
+static void serialPrintTelemetry()
+{
+    Serial.print("R current ");
+    Serial.print(currentLimiter.peakMilliAmps(), DEC);
+    Serial.print(" ");
+    Serial.print(currentLimiter.averageMilliAmps(), DEC);
+    Serial.println();
+    Serial.print("R memory ");
+    Serial.print(Memory::currentFreeBytes(), DEC);
+    Serial.print(" ");
+    Serial.print(Memory::minimumFreeBytes(), DEC);
+    Serial.println();
+#if AMBIENT_LIGHT_BRIGHTNESS
+    Serial.print("R ambient ");
+    Serial.print(AmbientLight::level(), DEC);
+    Serial.print(" ");
+    Serial.print(ambientDimmer.factor(), DEC);
+    Serial.println();
+#endif
+}
+
+// Applies the command the way the settings states do. Returns false for malformed commands and invalid values.
+static bool executeSerialCommand(DataClock & data, SerialCommands::Command const & command)
+{
+    if (!command.valid)
+    {
+        return false;
+    }
+
+    uint16_t const * const arguments = command.arguments;
+    bool const componentValid = (1 <= command.argumentCount) && (ClockFace::displayComponentCount > arguments[0]);
+    ClockFace::DisplayComponent const component = static_cast<ClockFace::DisplayComponent>(arguments[0]);
+
+    switch (command.name)
+    {
+    case 'T': // T hours minutes seconds
+    {
+        if ((3 != command.argumentCount) || (24 <= arguments[0]) || (60 <= arguments[1]) || (60 <= arguments[2]))
+        {
+            return false;
+        }
+        data.timeOfDay = ClockFace::TimeOfDay(arguments[0], arguments[1], arguments[2]);
+        writeTimeOfDayToRtc(data);
+        return true;
+    }
+    case 'C': // C component hue saturation
+    {
+        if (!componentValid || (3 != command.argumentCount) || (255 < arguments[1]) || (255 < arguments[2]))
+        {
+            return false;
+        }
+        ClockFace::HueSaturation const color(arguments[1], arguments[2]);
+        // As with the buttons, which skip such colors.
+        if (data.colorsSettings.colorConflicts(component, color))
+        {
+            return false;
+        }
+        data.colorsSettings.at(component).hueSaturation = color;
+        break;
+    }
+    case 'B': // B component brightness
+    {
+        if (!componentValid || (2 != command.argumentCount) || (255 < arguments[1]))
+        {
+            return false;
+        }
+        data.colorsSettings.at(component).brightness = arguments[1];
+        break;
+    }
+    case 'K': // K component kernel
+    {
+        if (!componentValid || (2 != command.argumentCount) || (ClockFace::selectableKernelCount <= arguments[1]))
+        {
+            return false;
+        }
+        data.colorsSettings.at(component).selectableKernel = static_cast<ClockFace::SelectableKernel>(arguments[1]);
+        break;
+    }
+    case 'L': // L length hue saturation - the seconds hand's trail [length 0: off]
+    {
+        if ((3 != command.argumentCount) || (ClockFace::maximumTrailLength < arguments[0]) || (255 < arguments[1]) || (255 < arguments[2]))
+        {
+            return false;
+        }
+        data.trailSettings.length = arguments[0];
+        data.trailSettings.hueSaturation = ClockFace::HueSaturation(arguments[1], arguments[2]);
+        if (0 == data.trailSettings.length)
+        {
+            data.trail.clear();
+        }
+        break;
+    }
+    case 'O': // O ring offset - index of the ring's 12 o'clock pixel
+    {
+        if ((2 != command.argumentCount) || (ringCount <= arguments[0]) || (ringPixelCounts[arguments[0]] <= arguments[1]))
+        {
+            return false;
+        }
+        data.ringIndexMap.setOffset(arguments[0], arguments[1]);
+        break;
+    }
+    case 'M': // M milliAmps - current budget of the LEDs
+    {
+        if ((1 != command.argumentCount) || (0 == arguments[0]))
+        {
+            return false;
+        }
+        data.currentBudgetMilliAmps = arguments[0];
+        break;
+    }
+    case 'D': // D - the settings as commands which set them [not the time - replaying a dump later would set an outdated one]
+    {
+        for (uint8_t i = 0; i < ClockFace::displayComponentCount; ++i)
+        {
+            serialPrintColorSettings(i, data.colorsSettings.at(static_cast<ClockFace::DisplayComponent>(i)));
+        }
+        serialPrintBackupSettings(data);
+#if EVENTS_FROM_RTC_ALARMS
+        serialPrintEventList();
+#endif
+        return true;
+    }
+#if EVENTS_FROM_RTC_ALARMS
+    case 'A': // A hours minutes type - add an event [type: Events::EventType]
+    {
+        if ((3 != command.argumentCount) || (24 <= arguments[0]) || (60 <= arguments[1]) || (Events::eventTypeCount <= arguments[2]))
+        {
+            return false;
+        }
+        if (!eventList.insert(Events::Event{static_cast<uint8_t>(arguments[0]), static_cast<uint8_t>(arguments[1]), static_cast<Events::EventType>(arguments[2])}))
+        {
+            return false;
+        }
+        storeEventList(data);
+        return true;
+    }
+    case 'E': // E [index] - erase the event at index [as listed by D] or all of them
+    {
+        if (0 == command.argumentCount)
+        {
+            eventList.count = 0;
+        }
+        else if ((1 == command.argumentCount) && (eventList.count > arguments[0]))
+        {
+            eventList.remove(arguments[0]);
+        }
+        else
+        {
+            return false;
+        }
+        storeEventList(data);
+        return true;
+    }
+    case 'H': // H 0|1 - hourly chime off/on
+    {
+        if ((1 != command.argumentCount) || (1 < arguments[0]))
+        {
+            return false;
+        }
+        eventList.hourlyChime = (1 == arguments[0]);
+        storeEventList(data);
+        return true;
+    }
+#endif
+    case 'R': // R - telemetry
+    {
+        serialPrintTelemetry();
+        return true;
+    }
+    default:
+    {
+        return false;
+    }
+    }
+
+    // A changed BackupValues setting - stored by loop() after the last command.
+    serialSettingsChanged = true;
+    serialSettingsChangedMillis = data.frameMillis;
+    data.transition.start(strip, data.frameMillis, valueTransitionDurationMs, Animation::Easing::easeOut);
+    return true;
+}
+#endif
+
+static uint8_t * physicalPixelsOfRing(uint8_t const ring)
+{
+#if DUAL_RING_TWO_PINS
+    return (0 == ring) ? physicalStrip.getPixels() : physicalStripOuterRing.getPixels();
+#else
+    return physicalStrip.getPixels() + ringLayout.rings[ring].firstPixel * ledBytesPerPixel;
+#endif
+}
+
+static void showStrip(Adafruit_NeoPixel const & strip, RingIndexMap const & ringIndexMap)
+{
+    for (uint8_t r = 0; r < ringCount; ++r)
+    {
+        ringIndexMap.toPhysical(r, physicalPixelsOfRing(r), strip.getPixels() + ringLayout.rings[r].firstPixel * ledBytesPerPixel, ledBytesPerPixel);
+    }
+#if LED_OUTPUT_USART_SPI
+    // Chained rings go out as one frame [DUAL_RING_TWO_PINS is excluded above].
+    Ws2812Usart::show(physicalStrip.getPixels(), physicalStrip.numPixels() * ledBytesPerPixel);
+#else
+    physicalStrip.show();
+#if DUAL_RING_TWO_PINS
+    physicalStripOuterRing.show();
+#endif
+#endif
+}
+
 void setup()
 {
+#if PRINT_SERIAL_BOOT_TIMING
+    bootTiming.setupBegin = micros();
+#endif
+
     // Power for the RTC, as I don't have enough 5V ports on the UNO.
+    // Done first, as the RTC needs a while until it answers on I2C - meanwhile everything else is set up.
     PinPowerRtc::initialize<AvrInputOutput::PinState::High>();
 
+    // Startup LEDs
+    physicalStrip.begin();   // INITIALIZE NeoPixel strip object (REQUIRED)
+#if DUAL_RING_TWO_PINS
+    physicalStripOuterRing.begin();
+#endif
+#if LED_OUTPUT_USART_SPI
+    Ws2812Usart::initialize();
+#endif
+    showStrip(strip, dataClock.ringIndexMap);   // Turn OFF all pixels ASAP
+    physicalStrip.setBrightness(255);
+#if DUAL_RING_TWO_PINS
+    physicalStripOuterRing.setBrightness(255);
+#endif
+
+    BackupValues backupValues(dataClock.colorsSettings, dataClock.currentBudgetMilliAmps, dataClock.trailSettings);
+    bool const readBack = Eeprom::readWithCrc(&backupValues, sizeof(BackupValues), backupValuesAddress)
+                          && (backupValuesLayout == backupValues.layout);
+    if (readBack)
+    {
+        dataClock.colorsSettings = backupValues.colorsSettings;
+        dataClock.currentBudgetMilliAmps = backupValues.currentBudgetMilliAmps;
+        dataClock.trailSettings = backupValues.trailSettings;
+        for (uint8_t r = 0; r < ringCount; ++r)
+        {
+            dataClock.ringIndexMap.setOffset(r, backupValues.ringOffsets[r]);
+        }
+    }
+    else
+    {
+        for (uint8_t i = 0; i < ClockFace::displayComponentCount; ++i)
+        {
+            ClockFace::ColorSettings & colorSettings = dataClock.colorsSettings.at(static_cast<ClockFace::DisplayComponent>(i));
+            colorSettings.brightness = defaultMaxBrightness;
+            colorSettings.hueSaturation = ClockFace::HueSaturation(pgm_read_byte(&displayComponentDefaults[i].hue), 255);
+            colorSettings.selectableKernel = static_cast<ClockFace::SelectableKernel>(pgm_read_byte(&displayComponentDefaults[i].selectableKernel));
+        }
+    }
+
     Helpers::TMP::Loop<4, WrapperInitialize>::impl();
 
+#if PRINT_SERIAL_BOOT_TIMING
+    bootTiming.settingsLoaded = micros();
+#endif
+
     // Start the I2C interface
     // For an Arduino Uno this entails: A4 - SDA, A5 - SCL
     Wire.begin();
 
-    // Use 12h-Mode.
-    myRTC.setClockMode(true);
+    waitForRtc(rtcI2cAddress, rtcPowerUpTimeoutMs);
 
-    // Startup LEDs
-    strip.begin();           // INITIALIZE NeoPixel strip object (REQUIRED)
-    strip.show();            // Turn OFF all pixels ASAP
-    strip.setBrightness(255);
+#if PRINT_SERIAL_BOOT_TIMING
+    bootTiming.rtcReady = micros();
+#endif
 
-    // Todo: save and load settings from eeprom
-    BackupValues backupValues(dataClock.colorsSettings);
-    bool const readBack = Eeprom::readWithCrc(&backupValues, sizeof(BackupValues), backupValuesAddress);
-    if (readBack)
+    // Use 24h-Mode, the settings set hours in [0, 24) - an RTC still in 12h-Mode [set by older firmware] is
+    // converted once, so that a regular boot needs no RTC write. setClockMode() only flips the mode bit.
+    bool h12Flag = false;
+    bool pmFlag = false;
+    uint8_t const hours = myRTC.getHour(h12Flag, pmFlag);
+    if (h12Flag)
     {
-        dataClock.colorsSettings = backupValues.colorsSettings;
+        myRTC.setClockMode(false);
+        myRTC.setHour((hours % 12) + (pmFlag ? 12 : 0));
     }
-    else
+
+#if SUBSECONDS_FROM_RTC_32KHZ
+    myRTC.enable32kHz(true);
+    SubsecondCounter::initialize();
+#endif
+
+#if EVENTS_FROM_RTC_ALARMS
+    if (!Eeprom::readWithCrc(&eventList, sizeof(Events::EventList), eventListAddress))
     {
-        dataClock.colorsSettings.at(DisplayComponent::hours).brightness = defaultMaxBrightness;
-        dataClock.colorsSettings.at(DisplayComponent::hours).selectableColor = SelectableColor::blue;
-        dataClock.colorsSettings.at(DisplayComponent::minutes).brightness = defaultMaxBrightness;
-        dataClock.colorsSettings.at(DisplayComponent::minutes).selectableColor = SelectableColor::green;
-        dataClock.colorsSettings.at(DisplayComponent::seconds).brightness = defaultMaxBrightness;
-        dataClock.colorsSettings.at(DisplayComponent::seconds).selectableColor = SelectableColor::red;
+        setDefaultEventList(eventList);
+        Eeprom::writeWithCrc(&eventList, sizeof(Events::EventList), eventListAddress);
     }
+    Events::initialize();
+    rescheduleEvents(dataClock);
+#endif
+
+#if AMBIENT_LIGHT_BRIGHTNESS
+    AmbientLight::initialize();
+    ambientDimmer.update(AmbientLight::level());
+#endif
 
-#if PRINT_SERIAL_TIME || PRINT_SERIAL_BUTTONS
+    // The first frame shall show the time right away instead of fading in.
+    dataClock.transition.stop();
+
+#if PRINT_SERIAL_TIME || PRINT_SERIAL_BUTTONS || PRINT_SERIAL_CURRENT || PRINT_SERIAL_LATENCY || PRINT_SERIAL_BOOT_TIMING || PRINT_SERIAL_PROFILE || PRINT_SERIAL_MEMORY || PRINT_SERIAL_FPS || PRINT_SERIAL_ENERGY || SERIAL_COMMANDS || TRACE_RECORD || TRACE_REPLAY || SOAK_RUN
     // Start the serial interface
     Serial.begin(57600);
 #endif
+
+#if TRACE_RECORD
+    Trace::recorder.begin(Serial);
+#endif
+#if TRACE_REPLAY
+    Trace::player.begin(Serial);
+#endif
+
+#if SOAK_RUN
+    soakMonitor.begin(cycleDurationMs * 1000UL);
+    // Hand positions are checked on the scale of the first ring.
+    soakPositionMonitor.begin(ringLayout.rings[0].pixelCount);
+#endif
+
+#if MEASURE_INTERRUPT_LATENCY
+    if (!Eeprom::readWithCrc(&previousRunInterruptLatencyMicros, sizeof(uint16_t), interruptLatencyAddress))
+    {
+        previousRunInterruptLatencyMicros = 0;
+    }
+    InterruptLatency::initialize();
+#endif
+
+#if PRINT_SERIAL_PROFILE
+    Profiler::initialize();
+#endif
+
+#if PRINT_SERIAL_BOOT_TIMING
+    bootTiming.setupEnd = micros();
+#endif
 }
 
 
 void loop()
 {
+#if SOAK_RUN
+    if (soakDurationMs <= soakMillis)
+    {
+        // Finished - the result has been reported.
+        return;
+    }
+#endif
+
+#if TRACE_REPLAY
+    // Blocks until the host sent the next frame's inputs.
+    Trace::player.beginFrame(Serial);
+    dataClock.frameMillis = Trace::player.now();
+    unsigned long const frameStartMicros = micros();
+#elif SOAK_RUN
+    dataClock.frameMillis = soakMillis;
+#else
+    dataClock.frameMillis = millis();
+#endif
+#if TRACE_RECORD
+    Trace::recorder.beginFrame(dataClock.frameMillis);
+#endif
+
     Helpers::TMP::Loop<4, WrapperUpdate>::impl();
 
+#if TRACE_RECORD
+    uint8_t buttonsDown = 0;
+    Helpers::TMP::Loop<4, WrapperCollectIsDown, uint8_t &>::impl(buttonsDown);
+    Trace::recorder.setButtonsDown(buttonsDown);
+#endif
+
 #if PRINT_SERIAL_BUTTONS
     serialPrintButton<ButtonTop>("ButtonTop");
     serialPrintButton<ButtonRight>("ButtonRight");
@@ -832,22 +1503,226 @@ void loop()
     serialPrintButton<ButtonLeft>("ButtonLeft");
 #endif
 
+#if EVENTS_FROM_RTC_ALARMS
+    // Only a flag test unless the RTC signalled an alarm.
+    if (Events::alarmPending())
+    {
+        uint8_t const dueEvents = eventScheduler.takeDueEvents(myRTC, eventList);
+        if (dueEvents & Events::dueNightStart)
+        {
+            dataClock.nightMode = true;
+        }
+        if (dueEvents & Events::dueNightEnd)
+        {
+            dataClock.nightMode = false;
+        }
+        if ((dueEvents & Events::dueChime) && !dataClock.nightMode && (chimeFlashCount > dataClock.alarmFlashesRemaining))
+        {
+            dataClock.alarmFlashesRemaining = chimeFlashCount;
+        }
+        if (dueEvents & Events::dueWake)
+        {
+            dataClock.alarmFlashesRemaining = wakeFlashCount;
+        }
+    }
+#endif
+
+#if SERIAL_COMMANDS
+    SerialCommands::Command command;
+    if (serialCommandParser.poll(Serial, serialCommandBytesPerCycle, command))
+    {
+        Serial.println(executeSerialCommand(dataClock, command) ? "OK" : "ERR");
+    }
+    if (serialSettingsChanged && ((dataClock.frameMillis - serialSettingsChangedMillis) >= serialSettingsStoreDelayMs))
+    {
+        storeBackupValues(dataClock);
+        serialSettingsChanged = false;
+    }
+#endif
+
+#if AMBIENT_LIGHT_BRIGHTNESS
+    if (ambientDimmer.update(AmbientLight::level()) && !dataClock.transition.isActive())
+    {
+        dataClock.transition.start(strip, dataClock.frameMillis, ambientTransitionDurationMs);
+    }
+#endif
+
     // Assume update to always be necessary - state must opt-out explicitely.
     dataClock.updateDisplay = true;
+    dataClock.frameScheduled = false;
+    dataClock.markPm = false;
 
     statemachine.process(dataClock);
 
+    if (dataClock.frameScheduled && !dataClock.transition.isActive())
+    {
+        dataClock.updateDisplay = dataClock.updateDisplay && frameScheduler.isDue(dataClock.frameMillis);
+    }
+    else
+    {
+        frameScheduler.invalidate();
+    }
+
     if (dataClock.updateDisplay)
     {
+#if SOAK_RUN
+        unsigned long const renderStartMicros = micros();
+#endif
         // Create color representation.
-        showTimeOfDay(strip, dataClock.timeOfDay, dataClock.subseconds, dataClock.colorsSettings);
+        ClockFace::ColorsSettings colorsSettings = dataClock.colorsSettings;
+        if (dataClock.markPm && (0 != ((dataClock.frameMillis / pmBlinkHalfPeriodMs) & 1)))
+        {
+            colorsSettings.at(ClockFace::DisplayComponent::hours).brightness = 0;
+        }
+        ClockFace::composeTimeOfDay(strip, ringLayout, dataClock.timeOfDay, dataClock.subseconds, colorsSettings);
+        if (0 < dataClock.trailSettings.length)
+        {
+            uint8_t const secondsBrightness = dataClock.colorsSettings.at(ClockFace::DisplayComponent::seconds).brightness;
+            dataClock.trail.addTo(strip, ringLayout.rings[trailRing].firstPixel, dataClock.trailSettings.scaledColor(secondsBrightness));
+        }
+#if AMBIENT_LIGHT_BRIGHTNESS
+        AmbientLight::scale(strip, ledBytesPerPixel, ambientDimmer.factor());
+#endif
+        dataClock.transition.apply(strip, dataClock.frameMillis);
+#if EVENTS_FROM_RTC_ALARMS
+        currentLimiter.limit(strip, ledBytesPerPixel, dataClock.nightMode ? nightCurrentBudgetMilliAmps : dataClock.currentBudgetMilliAmps);
+#else
+        currentLimiter.limit(strip, ledBytesPerPixel, dataClock.currentBudgetMilliAmps);
+#endif
+        showStrip(strip, dataClock.ringIndexMap);
+
+        double millisUntilChange = dataClock.frameScheduled
+                ? ClockFace::millisUntilTimeOfDayChanges(ringLayout, dataClock.timeOfDay, dataClock.subseconds, dataClock.colorsSettings)
+                : 0.;
+        if (0 < dataClock.trailSettings.length)
+        {
+            // The trail keeps fading while the hands rest.
+            uint16_t const millisUntilDecay = dataClock.trail.millisUntilDecay(dataClock.trailSettings.stepMs());
+            millisUntilChange = (millisUntilDecay < millisUntilChange) ? millisUntilDecay : millisUntilChange;
+        }
+        frameScheduler.frameRendered(dataClock.frameMillis, millisUntilChange);
+
+#if SOAK_RUN
+        soakMonitor.checkRenderTime(micros() - renderStartMicros);
+
+        ClockFace::ClockHand hands[ClockFace::clockHandCount];
+        ClockFace::clockHandsFromTimeOfDay(hands, ringLayout.rings[0].pixelCount, dataClock.timeOfDay, dataClock.subseconds, dataClock.colorsSettings);
+        double const positions[ClockFace::clockHandCount] = {hands[0].position, hands[1].position, hands[2].position};
+        soakPositionMonitor.checkPositions(positions);
+#endif
+
+#if PRINT_SERIAL_BOOT_TIMING
+        if (0 == bootTiming.firstFrame)
+        {
+            bootTiming.firstFrame = micros();
+            serialPrintBootTiming(bootTiming);
+        }
+#endif
     }
 
 #if PRINT_SERIAL_TIME
     serialPrintTimeOfDay(dataClock.timeOfDay);
 #endif
 
+#if PRINT_SERIAL_CURRENT
+    serialPrintCurrent(currentLimiter);
+#endif
+
+#if PRINT_SERIAL_MEMORY
+    serialPrintMemory();
+#endif
+
+#if MEASURE_INTERRUPT_LATENCY
+    uint16_t const interruptLatencyMicros = InterruptLatency::maximumMicros();
+    if (storedInterruptLatencyMicros < interruptLatencyMicros)
+    {
+        // Only written when the maximum grows - i.e. a few times shortly after startup.
+        storedInterruptLatencyMicros = interruptLatencyMicros;
+        Eeprom::writeWithCrc(&storedInterruptLatencyMicros, sizeof(uint16_t), interruptLatencyAddress);
+    }
+#endif
+
+#if PRINT_SERIAL_LATENCY
+    Serial.print("Interrupt latency [us] max: ");
+    Serial.print(interruptLatencyMicros, DEC);
+    Serial.print(" previous run: ");
+    Serial.print(previousRunInterruptLatencyMicros, DEC);
+    Serial.println();
+#endif
+
+#if PRINT_SERIAL_FPS
+    if (fpsReportIntervalMs <= (dataClock.frameMillis - lastFpsReportTime))
+    {
+        lastFpsReportTime = dataClock.frameMillis;
+        uint16_t const deciFramesPerSecond = frameScheduler.takeDeciFramesPerSecond(dataClock.frameMillis);
+        Serial.print("Frames per second: ");
+        Serial.print(deciFramesPerSecond / 10, DEC);
+        Serial.print(".");
+        Serial.print(deciFramesPerSecond % 10, DEC);
+        Serial.println();
+    }
+#endif
+
+#if PRINT_SERIAL_ENERGY
+    if (energyReportIntervalMs <= (dataClock.frameMillis - lastEnergyReportTime))
+    {
+        lastEnergyReportTime = dataClock.frameMillis;
+        ClockScaling::DutyCycle const dutyCycle = ClockScaling::takeDutyCycle(dataClock.frameMillis);
+        // Compared to busy waiting at the full clock: the charge saved per hour is the saved current times the idle fraction.
+        uint32_t const savedMicroAmpHoursPerHour = (0 < dutyCycle.totalMs)
+                ? static_cast<uint32_t>(activeFullClockMicroAmps - idleSlowClockMicroAmps) * dutyCycle.slowMs / dutyCycle.totalMs
+                : 0;
+        Serial.print("Reduced clock [ms] idle: ");
+        Serial.print(dutyCycle.slowMs, DEC);
+        Serial.print(" of: ");
+        Serial.print(dutyCycle.totalMs, DEC);
+        Serial.print(" saved [uAh per hour]: ");
+        Serial.print(savedMicroAmpHoursPerHour, DEC);
+        Serial.println();
+    }
+#endif
+
+#if PRINT_SERIAL_PROFILE
+    if (profileDumpIntervalMs <= (dataClock.frameMillis - lastProfileDumpTime))
+    {
+        lastProfileDumpTime = dataClock.frameMillis;
+        Profiler::dump(Serial);
+    }
+#endif
+
+#if TRACE_RECORD
+    Trace::recorder.endFrame(Serial);
+#endif
+
+#if SOAK_RUN
+    soakMillis += soakStepMs;
+    if (soakReportIntervalMs <= (soakMillis - lastSoakReportTime))
+    {
+        lastSoakReportTime = soakMillis;
+        serialPrintTimeOfDay(dataClock.timeOfDay);
+        soakMonitor.print(Serial);
+        soakPositionMonitor.print(Serial);
+    }
+    if (soakDurationMs <= soakMillis)
+    {
+        Serial.println((soakMonitor.passed() && soakPositionMonitor.passed()) ? "Soak run finished: PASS" : "Soak run finished: FAIL");
+    }
+#endif
+
+#if TRACE_REPLAY
+    // The host paces the replay - no delay.
+    Trace::player.endFrame(Serial, dataClock.updateDisplay, static_cast<uint16_t>(micros() - frameStartMicros), strip.getPixels(), ledCount * ledBytesPerPixel);
+#elif !SOAK_RUN && IDLE_AT_REDUCED_CLOCK
+#if LED_OUTPUT_USART_SPI
+    // The USART's baud rate follows the CPU clock.
+    Ws2812Usart::waitUntilIdle();
+#elif PRINT_SERIAL_TIME || PRINT_SERIAL_BUTTONS || PRINT_SERIAL_CURRENT || PRINT_SERIAL_LATENCY || PRINT_SERIAL_BOOT_TIMING || PRINT_SERIAL_MEMORY || PRINT_SERIAL_FPS || PRINT_SERIAL_ENERGY || TRACE_RECORD
+    Serial.flush();
+#endif
+    ClockScaling::idle(cycleDurationMs);
+#elif !SOAK_RUN
     delay(cycleDurationMs);
+#endif
 }
 
 
@@ -865,7 +1740,7 @@ Helpers::AbstractState<DataClock> const & StateClockDisplay::process(DataClock &
     }
     else if (ButtonSettings::isDownLong())
     {
-        data.timeOfDay = getTimeOfDayFromRTC(myRTC);
+        data.timeOfDay = readTimeOfDay();
 
         data.updateDisplay = false;
 
@@ -874,22 +1749,62 @@ Helpers::AbstractState<DataClock> const & StateClockDisplay::process(DataClock &
 
     if (data.updateDisplay)
     {
+        data.frameScheduled = true;
+
+#if SUBSECONDS_FROM_RTC_32KHZ
+        uint16_t const countBeforeRead = SubsecondCounter::count();
+        data.timeOfDay = readTimeOfDay();
+        uint16_t const countAfterRead = SubsecondCounter::count();
+
+        uint8_t const previousSeconds = data.settingsClockDisplay.previousSeconds;
+        bool const secondChanged = (previousSeconds != data.timeOfDay.seconds);
+        bool const secondAdvanced = (previousSeconds != data.settingsClockDisplay.previousSecondsInvalid)
+                && (RingArithmetic::Ring<60>::normalize(previousSeconds + 1) == data.timeOfDay.seconds);
+        data.settingsClockDisplay.previousSeconds = data.timeOfDay.seconds;
+
+        uint16_t const phase = data.settingsClockDisplay.secondPhase.update(countBeforeRead, countAfterRead, secondChanged, secondAdvanced);
+        data.subseconds = static_cast<double>(phase) / SubsecondCounter::countsPerSecond;
+#else
         // Get hour, minutes, and seconds from RTC.
-        data.timeOfDay = getTimeOfDayFromRTC(myRTC);
+        data.timeOfDay = readTimeOfDay();
 
         // simulate subseconds
         if (data.settingsClockDisplay.previousSeconds != data.timeOfDay.seconds)
         {
             // seconds changed -> reset subseconds to 0
-            data.settingsClockDisplay.lastSecondChangeTime = millis();
+            data.settingsClockDisplay.lastSecondChangeTime = data.frameMillis;
             data.settingsClockDisplay.previousSeconds = data.timeOfDay.seconds;
             data.subseconds = 0;
         }
         else
         {
-            // simulate via millis()
-            data.subseconds = static_cast<double>(millis() - data.settingsClockDisplay.lastSecondChangeTime) / 1000.;
+            // simulate via millis()
+            data.subseconds = static_cast<double>(data.frameMillis - data.settingsClockDisplay.lastSecondChangeTime) / 1000.;
+        }
+#endif
+
+        if (0 < data.trailSettings.length)
+        {
+            double const secondsPosition = (static_cast<double>(data.timeOfDay.seconds) + data.subseconds) / 60. * trailPixelCount;
+            data.trail.update(data.frameMillis, RingArithmetic::Ring<trailPixelCount>::normalize(static_cast<int16_t>(secondsPosition + .5)), data.trailSettings.stepMs());
+        }
+
+#if EVENTS_FROM_RTC_ALARMS
+        // Chimes and alarms flash the ring white and fade back to the time - any button ends them.
+        if (0 < getButtonsAreDown())
+        {
+            data.alarmFlashesRemaining = 0;
+        }
+        else if ((0 < data.alarmFlashesRemaining) && !data.transition.isActive())
+        {
+            --data.alarmFlashesRemaining;
+            for (uint16_t i = 0; i < strip.numPixels(); ++i)
+            {
+                strip.setPixelColor(i, Colors::White);
+            }
+            data.transition.start(strip, data.frameMillis, alarmFlashDurationMs, Animation::Easing::easeIn);
         }
+#endif
     }
 
     return *nextState;
@@ -903,6 +1818,10 @@ void StateClockSettings::init(DataClock & data) const
     data.settingsClockSettings.modeChangeButtonWasUpOnceInThisMode = false;
 
     data.subseconds = 0;
+
+    data.trail.clear();
+
+    data.transition.start(strip, data.frameMillis, modeTransitionDurationMs);
 }
 
 Helpers::AbstractState<DataClock> const & StateClockSettings::process(DataClock & data) const
@@ -918,18 +1837,11 @@ Helpers::AbstractState<DataClock> const & StateClockSettings::process(DataClock
     }
     else if (StateClockSettings::ButtonSelectOrExit::isDownLong() && (1 == getButtonsAreDown()))
     {
-        BackupValues const backupValues(data.colorsSettings);
-        Eeprom::writeWithCrc(&backupValues, sizeof(BackupValues), backupValuesAddress);
+        storeBackupValues(data);
 
         nextState = &stateClockDisplay;
 
-        myRTC.setSecond(data.timeOfDay.seconds);
-        myRTC.setMinute(data.timeOfDay.minutes);
-        myRTC.setHour(data.timeOfDay.hours);
-        // myRTC.setDoW(7);
-        // myRTC.setDate(9);
-        // myRTC.setMonth(6);
-        // myRTC.setYear(24);
+        writeTimeOfDayToRtc(data);
 #if PRINT_SERIAL_TIME
         Serial.print("Settings: ");
         serialPrintTimeOfDay(data.timeOfDay);
@@ -977,6 +1889,7 @@ Helpers::AbstractState<DataClock> const & StateModifyValue::process(DataClock &
             if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
             {
                 incrementTimeOfDayComponent(data.timeOfDay, getSettingsModify(data).settingsSelection);
+                startValueTransition(data);
             }
         }
         else if (StateClockSettings::ButtonDown::isDownLong())
@@ -985,6 +1898,7 @@ Helpers::AbstractState<DataClock> const & StateModifyValue::process(DataClock &
             if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
             {
                 decrementTimeOfDayComponent(data.timeOfDay, getSettingsModify(data).settingsSelection);
+                startValueTransition(data);
             }
         }
 
@@ -996,14 +1910,19 @@ Helpers::AbstractState<DataClock> const & StateModifyValue::process(DataClock &
         if (StateClockSettings::ButtonUp::releasedAfterShort())
         {
             incrementTimeOfDayComponent(data.timeOfDay, getSettingsModify(data).settingsSelection);
+            startValueTransition(data);
         }
 
         if (StateClockSettings::ButtonDown::releasedAfterShort())
         {
             decrementTimeOfDayComponent(data.timeOfDay, getSettingsModify(data).settingsSelection);
+            startValueTransition(data);
         }
     }
 
+    // The 12 hours of the face cannot tell AM from PM.
+    data.markPm = (SettingsSelection::hours == getSettingsModify(data).settingsSelection) && (12 <= data.timeOfDay.hours);
+
     return *nextState;
 }
 
@@ -1102,13 +2021,15 @@ Helpers::AbstractState<DataClock> const & StateModifyColor::process(DataClock &
             getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
             if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
             {
-                SelectableColor & colorToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableColor;
-                SelectableColor newColor = nextSelectableColor(colorToModify);
-                while (data.colorsSettings.colorConflicts(newColor))
+                ClockFace::DisplayComponent const component = displayComponentFrom(getSettingsModify(data).settingsSelection);
+                ClockFace::HueSaturation & colorToModify = data.colorsSettings.at(component).hueSaturation;
+                ClockFace::HueSaturation newColor = ClockFace::nextPaletteColor(colorToModify);
+                while (data.colorsSettings.colorConflicts(component, newColor))
                 {
-                    newColor = nextSelectableColor(newColor);
+                    newColor = ClockFace::nextPaletteColor(newColor);
                 }
                 colorToModify = newColor;
+                startValueTransition(data);
             }
         }
         else if (StateClockSettings::ButtonDown::isDownLong())
@@ -1116,44 +2037,350 @@ Helpers::AbstractState<DataClock> const & StateModifyColor::process(DataClock &
             getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
             if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
             {
-                SelectableColor & colorToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableColor;
-                SelectableColor newColor = previousSelectableColor(colorToModify);
-                while (data.colorsSettings.colorConflicts(newColor))
+                ClockFace::DisplayComponent const component = displayComponentFrom(getSettingsModify(data).settingsSelection);
+                ClockFace::HueSaturation & colorToModify = data.colorsSettings.at(component).hueSaturation;
+                ClockFace::HueSaturation newColor = ClockFace::previousPaletteColor(colorToModify);
+                while (data.colorsSettings.colorConflicts(component, newColor))
                 {
-                    newColor = previousSelectableColor(newColor);
+                    newColor = ClockFace::previousPaletteColor(newColor);
                 }
                 colorToModify = newColor;
+                startValueTransition(data);
             }
         }
 
 
         if (StateClockSettings::ButtonBrightnessOrColor::releasedAfterShort())
         {
-            nextState = &stateModifyValue;
+            nextState = &stateModifyKernel;
         }
 
         if (StateClockSettings::ButtonUp::releasedAfterShort())
         {
-            SelectableColor & colorToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableColor;
-            SelectableColor newColor = nextSelectableColor(colorToModify);
-            while (data.colorsSettings.colorConflicts(newColor))
+            ClockFace::DisplayComponent const component = displayComponentFrom(getSettingsModify(data).settingsSelection);
+            ClockFace::HueSaturation & colorToModify = data.colorsSettings.at(component).hueSaturation;
+            ClockFace::HueSaturation newColor = ClockFace::nextPaletteColor(colorToModify);
+            while (data.colorsSettings.colorConflicts(component, newColor))
             {
-                newColor = nextSelectableColor(newColor);
+                newColor = ClockFace::nextPaletteColor(newColor);
             }
             colorToModify = newColor;
+            startValueTransition(data);
         }
 
         if (StateClockSettings::ButtonDown::releasedAfterShort())
         {
-            SelectableColor & colorToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableColor;
-            SelectableColor newColor = previousSelectableColor(colorToModify);
-            while (data.colorsSettings.colorConflicts(newColor))
+            ClockFace::DisplayComponent const component = displayComponentFrom(getSettingsModify(data).settingsSelection);
+            ClockFace::HueSaturation & colorToModify = data.colorsSettings.at(component).hueSaturation;
+            ClockFace::HueSaturation newColor = ClockFace::previousPaletteColor(colorToModify);
+            while (data.colorsSettings.colorConflicts(component, newColor))
             {
-                newColor = previousSelectableColor(newColor);
+                newColor = ClockFace::previousPaletteColor(newColor);
             }
             colorToModify = newColor;
+            startValueTransition(data);
+        }
+    }
+
+    return *nextState;
+}
+
+Helpers::AbstractState<DataClock> const & StateModifyKernel::process(DataClock & data) const
+{
+    Helpers::AbstractState<DataClock> const * nextState = this;
+
+    uint8_t const numberOfButtonsAreDown = getButtonsAreDown();
+
+    if (1 < numberOfButtonsAreDown)
+    {
+        // In this mode at most 1 button is supposed to be pressed at the same time.
+        // Reset accumulation counter but do nothing else if more than 1 buttons are pressed.
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+    else
+    {
+        if (0 == numberOfButtonsAreDown)
+        {
+            getSettingsModify(data).longPressDurationAccumulation = 0;
+        }
+        else if (StateClockSettings::ButtonBrightnessOrColor::isDownLong())
+        {
+            nextState = &stateModifyBrightness;
+        }
+        else if (StateClockSettings::ButtonSelectOrExit::pressed())
+        {
+            getSettingsModify(data).settingsSelection = nextSettingsSelection(getSettingsModify(data).settingsSelection);
+        }
+        else if (StateClockSettings::ButtonUp::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                ClockFace::SelectableKernel & kernelToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableKernel;
+                kernelToModify = ClockFace::nextSelectableKernel(kernelToModify);
+                startValueTransition(data);
+            }
+        }
+        else if (StateClockSettings::ButtonDown::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                ClockFace::SelectableKernel & kernelToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableKernel;
+                kernelToModify = ClockFace::previousSelectableKernel(kernelToModify);
+                startValueTransition(data);
+            }
+        }
+
+
+        if (StateClockSettings::ButtonBrightnessOrColor::releasedAfterShort())
+        {
+            nextState = &stateModifyOrientation;
+        }
+
+        if (StateClockSettings::ButtonUp::releasedAfterShort())
+        {
+            ClockFace::SelectableKernel & kernelToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableKernel;
+            kernelToModify = ClockFace::nextSelectableKernel(kernelToModify);
+            startValueTransition(data);
+        }
+
+        if (StateClockSettings::ButtonDown::releasedAfterShort())
+        {
+            ClockFace::SelectableKernel & kernelToModify = data.colorsSettings.at(displayComponentFrom(getSettingsModify(data).settingsSelection)).selectableKernel;
+            kernelToModify = ClockFace::previousSelectableKernel(kernelToModify);
+            startValueTransition(data);
+        }
+    }
+
+    return *nextState;
+}
+
+Helpers::AbstractState<DataClock> const & StateModifyOrientation::process(DataClock & data) const
+{
+    Helpers::AbstractState<DataClock> const * nextState = this;
+
+    uint8_t const numberOfButtonsAreDown = getButtonsAreDown();
+
+    if (1 < numberOfButtonsAreDown)
+    {
+        // In this mode at most 1 button is supposed to be pressed at the same time.
+        // Reset accumulation counter but do nothing else if more than 1 buttons are pressed.
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+    else
+    {
+        // The offset applies to the whole ring of the selected hand.
+        // The logical frame does not change with it, hence there is nothing to crossfade.
+        if (0 == numberOfButtonsAreDown)
+        {
+            getSettingsModify(data).longPressDurationAccumulation = 0;
+        }
+        else if (StateClockSettings::ButtonBrightnessOrColor::isDownLong())
+        {
+            nextState = &stateModifyBrightness;
+        }
+        else if (StateClockSettings::ButtonSelectOrExit::pressed())
+        {
+            getSettingsModify(data).settingsSelection = nextSettingsSelection(getSettingsModify(data).settingsSelection);
+        }
+        else if (StateClockSettings::ButtonUp::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                data.ringIndexMap.incrementOffset(ringOfSelection(getSettingsModify(data).settingsSelection));
+            }
+        }
+        else if (StateClockSettings::ButtonDown::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                data.ringIndexMap.decrementOffset(ringOfSelection(getSettingsModify(data).settingsSelection));
+            }
+        }
+
+
+        if (StateClockSettings::ButtonBrightnessOrColor::releasedAfterShort())
+        {
+            nextState = &stateModifyTrailLength;
+        }
+
+        if (StateClockSettings::ButtonUp::releasedAfterShort())
+        {
+            data.ringIndexMap.incrementOffset(ringOfSelection(getSettingsModify(data).settingsSelection));
+        }
+
+        if (StateClockSettings::ButtonDown::releasedAfterShort())
+        {
+            data.ringIndexMap.decrementOffset(ringOfSelection(getSettingsModify(data).settingsSelection));
+        }
+    }
+
+    return *nextState;
+}
+
+// The time stands still while it is set - a hand running at one pixel per second previews the trail.
+static void previewTrail(DataClock & data)
+{
+    if (0 < data.trailSettings.length)
+    {
+        data.trail.update(data.frameMillis, (data.frameMillis / 1000) % trailPixelCount, data.trailSettings.stepMs());
+    }
+}
+
+static void incrementTrailLength(DataClock & data)
+{
+    if (ClockFace::maximumTrailLength > data.trailSettings.length)
+    {
+        ++data.trailSettings.length;
+    }
+}
+
+static void decrementTrailLength(DataClock & data)
+{
+    if (0 < data.trailSettings.length)
+    {
+        --data.trailSettings.length;
+    }
+    if (0 == data.trailSettings.length)
+    {
+        data.trail.clear();
+    }
+}
+
+Helpers::AbstractState<DataClock> const & StateModifyTrailLength::process(DataClock & data) const
+{
+    Helpers::AbstractState<DataClock> const * nextState = this;
+
+    uint8_t const numberOfButtonsAreDown = getButtonsAreDown();
+
+    if (1 < numberOfButtonsAreDown)
+    {
+        // In this mode at most 1 button is supposed to be pressed at the same time.
+        // Reset accumulation counter but do nothing else if more than 1 buttons are pressed.
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+    else
+    {
+        if (0 == numberOfButtonsAreDown)
+        {
+            getSettingsModify(data).longPressDurationAccumulation = 0;
+        }
+        else if (StateClockSettings::ButtonBrightnessOrColor::isDownLong())
+        {
+            nextState = &stateModifyBrightness;
+        }
+        else if (StateClockSettings::ButtonSelectOrExit::pressed())
+        {
+            getSettingsModify(data).settingsSelection = nextSettingsSelection(getSettingsModify(data).settingsSelection);
+        }
+        else if (StateClockSettings::ButtonUp::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                incrementTrailLength(data);
+            }
+        }
+        else if (StateClockSettings::ButtonDown::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                decrementTrailLength(data);
+            }
+        }
+
+
+        if (StateClockSettings::ButtonBrightnessOrColor::releasedAfterShort())
+        {
+            nextState = &stateModifyTrailColor;
+        }
+
+        if (StateClockSettings::ButtonUp::releasedAfterShort())
+        {
+            incrementTrailLength(data);
+        }
+
+        if (StateClockSettings::ButtonDown::releasedAfterShort())
+        {
+            decrementTrailLength(data);
+        }
+    }
+
+    previewTrail(data);
+
+    return *nextState;
+}
+
+Helpers::AbstractState<DataClock> const & StateModifyTrailColor::process(DataClock & data) const
+{
+    Helpers::AbstractState<DataClock> const * nextState = this;
+
+    uint8_t const numberOfButtonsAreDown = getButtonsAreDown();
+
+    if (1 < numberOfButtonsAreDown)
+    {
+        // In this mode at most 1 button is supposed to be pressed at the same time.
+        // Reset accumulation counter but do nothing else if more than 1 buttons are pressed.
+        getSettingsModify(data).longPressDurationAccumulation = 0;
+    }
+    else
+    {
+        // The trail may take the seconds hand's color - it only shows behind that hand.
+        if (0 == numberOfButtonsAreDown)
+        {
+            getSettingsModify(data).longPressDurationAccumulation = 0;
+        }
+        else if (StateClockSettings::ButtonBrightnessOrColor::isDownLong())
+        {
+            nextState = &stateModifyBrightness;
+        }
+        else if (StateClockSettings::ButtonSelectOrExit::pressed())
+        {
+            getSettingsModify(data).settingsSelection = nextSettingsSelection(getSettingsModify(data).settingsSelection);
+        }
+        else if (StateClockSettings::ButtonUp::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                data.trailSettings.hueSaturation = ClockFace::nextPaletteColor(data.trailSettings.hueSaturation);
+                startValueTransition(data);
+            }
+        }
+        else if (StateClockSettings::ButtonDown::isDownLong())
+        {
+            getSettingsModify(data).longPressDurationAccumulation = incrementUint8Capped(getSettingsModify(data).longPressDurationAccumulation);
+            if (longPressDurationActive(getSettingsModify(data).longPressDurationAccumulation))
+            {
+                data.trailSettings.hueSaturation = ClockFace::previousPaletteColor(data.trailSettings.hueSaturation);
+                startValueTransition(data);
+            }
+        }
+
+
+        if (StateClockSettings::ButtonBrightnessOrColor::releasedAfterShort())
+        {
+            nextState = &stateModifyValue;
+        }
+
+        if (StateClockSettings::ButtonUp::releasedAfterShort())
+        {
+            data.trailSettings.hueSaturation = ClockFace::nextPaletteColor(data.trailSettings.hueSaturation);
+            startValueTransition(data);
+        }
+
+        if (StateClockSettings::ButtonDown::releasedAfterShort())
+        {
+            data.trailSettings.hueSaturation = ClockFace::previousPaletteColor(data.trailSettings.hueSaturation);
+            startValueTransition(data);
         }
     }
 
+    previewTrail(data);
+
     return *nextState;
 }
@@ -0,0 +1,92 @@
+#ifndef RINGORIENTATION_HPP
+#define RINGORIENTATION_HPP
+
+#include <stdint.h>
+
+namespace RingOrientation
+{
+
+// Direction in which the physical pixel indices run, seen from the front.
+enum class Direction : uint8_t
+{
+    clockwise,
+    counterClockwise
+};
+
+/**
+ * @brief The IndexMap class Maps logical pixel indices [0 at 12 o'clock, running clockwise] to the
+ * physical ones of the mounted rings - ringCount rings of ringPixelCounts chained in this order.
+ * Everything is rendered in logical order - the map is applied once per frame while copying the
+ * framebuffer for sending, so the render loops stay untouched. The direction is a property of the
+ * enclosure and hence fixed at compile time, the offset of each ring [physical index of its 12 o'clock
+ * pixel] can be changed at runtime and only then is the ring's part of the map recomputed.
+ */
+template<uint8_t ringCount, uint8_t pixelCount, Direction direction>
+class IndexMap
+{
+public:
+    explicit IndexMap(uint8_t const (&ringPixelCounts)[ringCount], uint8_t const offset = 0)
+    {
+        uint8_t firstPixel = 0;
+        for (uint8_t r = 0; r < ringCount; ++r)
+        {
+            firstPixels[r] = firstPixel;
+            this->ringPixelCounts[r] = ringPixelCounts[r];
+            firstPixel += ringPixelCounts[r];
+            setOffset(r, offset);
+        }
+    }
+
+    void setOffset(uint8_t const ring, uint8_t const newOffset)
+    {
+        uint8_t const ringPixelCount = ringPixelCounts[ring];
+        offsets[ring] = newOffset % ringPixelCount;
+        for (uint8_t i = 0; i < ringPixelCount; ++i)
+        {
+            uint8_t const step = (Direction::clockwise == direction) ? i : static_cast<uint8_t>((ringPixelCount - i) % ringPixelCount);
+            physicalIndices[firstPixels[ring] + i] = (offsets[ring] + step) % ringPixelCount;
+        }
+    }
+
+    uint8_t getOffset(uint8_t const ring) const
+    {
+        return offsets[ring];
+    }
+
+    // Rotate a ring by one pixel - wraps around.
+    void incrementOffset(uint8_t const ring)
+    {
+        setOffset(ring, offsets[ring] + 1);
+    }
+
+    void decrementOffset(uint8_t const ring)
+    {
+        setOffset(ring, offsets[ring] + ringPixelCounts[ring] - 1);
+    }
+
+    // Copy a ring's frame from logical to physical order - both point to the ring's first pixel, they must not overlap.
+    void toPhysical(uint8_t const ring, uint8_t * const physical, uint8_t const * const logical, uint8_t const bytesPerPixel) const
+    {
+        uint8_t const * const ringPhysicalIndices = physicalIndices + firstPixels[ring];
+        for (uint8_t i = 0; i < ringPixelCounts[ring]; ++i)
+        {
+            uint8_t * const target = physical + ringPhysicalIndices[i] * bytesPerPixel;
+            uint8_t const * const source = logical + i * bytesPerPixel;
+            for (uint8_t b = 0; b < bytesPerPixel; ++b)
+            {
+                target[b] = source[b];
+            }
+        }
+    }
+
+private:
+    uint8_t firstPixels[ringCount];
+    uint8_t ringPixelCounts[ringCount];
+    uint8_t offsets[ringCount];
+    // Ring local physical indices, all rings one after another.
+    uint8_t physicalIndices[pixelCount];
+};
+
+} // namespace RingOrientation
+
+#endif // RINGORIENTATION_HPP
@@ -0,0 +1,111 @@
+#include "SerialCommands.hpp"
+
+#include <ctype.h>
+
+namespace // anonymous namespace
+{
+
+bool isSeparator(char const character)
+{
+    return (' ' == character) || (',' == character) || (':' == character) || ('\t' == character);
+}
+
+} // anonymous namespace
+
+namespace SerialCommands
+{
+
+bool Parser::poll(Stream & stream, uint8_t const maximumByteCount, Command & command)
+{
+    for (uint8_t i = 0; (i < maximumByteCount) && (0 < stream.available()); ++i)
+    {
+        if (consume(static_cast<char>(stream.read())))
+        {
+            command = current;
+            current = Command();
+            inNumber = false;
+            malformed = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Parser::endNumber()
+{
+    if (inNumber)
+    {
+        ++current.argumentCount;
+        inNumber = false;
+    }
+}
+
+bool Parser::consume(char const character)
+{
+    if ('\r' == character)
+    {
+        return false;
+    }
+
+    if ('\n' == character)
+    {
+        endNumber();
+        if ((0 == current.name) && !malformed)
+        {
+            // Empty line.
+            return false;
+        }
+        current.valid = !malformed;
+        return true;
+    }
+
+    if (malformed)
+    {
+        // Skip the rest of the line.
+        return false;
+    }
+
+    if (0 == current.name)
+    {
+        if (isalpha(character))
+        {
+            current.name = toupper(character);
+        }
+        else if (!isSeparator(character))
+        {
+            malformed = true;
+        }
+    }
+    else if (isdigit(character))
+    {
+        if (!inNumber)
+        {
+            if (maximumArgumentCount <= current.argumentCount)
+            {
+                malformed = true;
+                return false;
+            }
+            current.arguments[current.argumentCount] = 0;
+            inNumber = true;
+        }
+        uint16_t & argument = current.arguments[current.argumentCount];
+        uint8_t const digit = character - '0';
+        if ((UINT16_MAX - digit) / 10 < argument)
+        {
+            malformed = true;
+            return false;
+        }
+        argument = argument * 10 + digit;
+    }
+    else if (isSeparator(character))
+    {
+        endNumber();
+    }
+    else
+    {
+        malformed = true;
+    }
+    return false;
+}
+
+} // namespace SerialCommands
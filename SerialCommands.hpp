@@ -0,0 +1,48 @@
+#ifndef SERIALCOMMANDS_HPP
+#define SERIALCOMMANDS_HPP
+
+#include <Arduino.h>
+
+/**
+ * Line based configuration commands via Serial [see tools/configure.py for the host side]:
+ * a letter followed by up to maximumArgumentCount unsigned numbers, separated by spaces, commas
+ * or colons, terminated by '\n' [a '\r' is ignored], e.g. "T 13:45:00". The Parser consumes the
+ * bytes one by one as they arrive, so it keeps no line buffer and never waits for the rest of a line.
+ * Executing a command is left to the caller, it answers with lines starting with the command's
+ * letter and a final "OK" or "ERR". The host sends the next command only after that, so the RX
+ * buffer cannot overflow even though only a few bytes are consumed per loop() cycle.
+ */
+namespace SerialCommands
+{
+
+uint8_t constexpr maximumArgumentCount = 4;
+
+struct Command
+{
+    char name = 0;
+    uint8_t argumentCount = 0;
+    uint16_t arguments[maximumArgumentCount] = {};
+    // False for malformed lines - too many or too large numbers, unexpected characters.
+    bool valid = false;
+};
+
+class Parser
+{
+public:
+    // Consumes at most maximumByteCount of the bytes available. Returns true once a line is complete - command holds it then.
+    bool poll(Stream & stream, uint8_t const maximumByteCount, Command & command);
+
+private:
+    // Returns true at the end of a non-empty line.
+    bool consume(char const character);
+
+    void endNumber();
+
+    Command current;
+    bool inNumber = false;
+    bool malformed = false;
+};
+
+} // namespace SerialCommands
+
+#endif // SERIALCOMMANDS_HPP
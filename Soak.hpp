@@ -0,0 +1,67 @@
+#ifndef SOAK_HPP
+#define SOAK_HPP
+
+#include <Arduino.h>
+
+/**
+ * Checks for accelerated-time soak runs [SOAK_RUN].
+ * The firmware runs without delay on simulated time, so that a day of clock operation
+ * passes in a fraction of the time. Per frame the monitor gets the render time and counts
+ * the frames exceeding the render budget, the hand positions go to SoakPositions.hpp.
+ * On the device a microsecond is F_CPU / 1000000 cycles. The host soak [tools/soak] runs
+ * the same code through days of clock time in seconds - its render times are the host's.
+ */
+namespace Soak
+{
+
+class Monitor
+{
+public:
+    void begin(unsigned long const budgetMicros)
+    {
+        this->budgetMicros = budgetMicros;
+    }
+
+    void checkRenderTime(unsigned long const renderMicros)
+    {
+        ++renderedFrames;
+        renderMicrosSum += renderMicros;
+        if (maximumRenderMicros < renderMicros)
+        {
+            maximumRenderMicros = renderMicros;
+        }
+        if (budgetMicros < renderMicros)
+        {
+            ++overBudgetFrames;
+        }
+    }
+
+    bool passed() const
+    {
+        return (0 == overBudgetFrames);
+    }
+
+    void print(Print & print) const
+    {
+        print.print("Soak frames rendered: ");
+        print.print(renderedFrames, DEC);
+        print.print(" render [us] average: ");
+        print.print((0 == renderedFrames) ? 0. : static_cast<double>(renderMicrosSum) / renderedFrames, 1);
+        print.print(" max: ");
+        print.print(maximumRenderMicros, DEC);
+        print.print(" over budget: ");
+        print.print(overBudgetFrames, DEC);
+        print.println(passed() ? " PASS" : " FAIL");
+    }
+
+private:
+    unsigned long budgetMicros = 0;
+    uint32_t renderedFrames = 0;
+    uint64_t renderMicrosSum = 0;   // days of frames overflow 32 bits
+    unsigned long maximumRenderMicros = 0;
+    uint32_t overBudgetFrames = 0;
+};
+
+} // namespace Soak
+
+#endif // SOAK_HPP
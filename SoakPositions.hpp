@@ -0,0 +1,79 @@
+#ifndef SOAKPOSITIONS_HPP
+#define SOAKPOSITIONS_HPP
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "NeoPixelPatterns.hpp"
+
+/**
+ * Hand motion check of soak runs [SOAK_RUN, see Soak.hpp]. Per frame the monitor gets the hand
+ * positions the firmware shows and counts hands moving backwards [modulo the ring]. On the host
+ * [tools/soak] days of clock time pass in seconds, so every wrap-around [seconds, minutes, hours,
+ * the ring itself] is executed many times.
+ */
+namespace Soak
+{
+
+template<uint8_t handCount>
+class PositionMonitor
+{
+public:
+    void begin(uint16_t const pixelCount)
+    {
+        this->pixelCount = pixelCount;
+        started = false;
+    }
+
+    void checkPositions(double const (&positions)[handCount])
+    {
+        for (uint8_t h = 0; h < handCount; ++h)
+        {
+            // Wraps around [0, pixelCount) - a hand passing 12 o'clock moves forward.
+            double const step = NeoPixelPatterns::symmetrizePosition(positions[h] - previousPositions[h], static_cast<double>(pixelCount));
+            if (started && (0. > step))
+            {
+                ++backwardStepCounts[h];
+            }
+            previousPositions[h] = positions[h];
+        }
+        started = true;
+        ++frameCount;
+    }
+
+    bool passed() const
+    {
+        for (uint8_t h = 0; h < handCount; ++h)
+        {
+            if (0 != backwardStepCounts[h])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void print(Print & print) const
+    {
+        print.print("Soak frames checked: ");
+        print.print(frameCount, DEC);
+        print.print(" backward steps:");
+        for (uint8_t h = 0; h < handCount; ++h)
+        {
+            print.print(" ");
+            print.print(backwardStepCounts[h], DEC);
+        }
+        print.println(passed() ? " PASS" : " FAIL");
+    }
+
+private:
+    uint16_t pixelCount = 0;
+    bool started = false;
+    double previousPositions[handCount] = {};
+    uint32_t frameCount = 0;
+    uint32_t backwardStepCounts[handCount] = {};
+};
+
+} // namespace Soak
+
+#endif // SOAKPOSITIONS_HPP
@@ -0,0 +1,108 @@
+#include "SubsecondCounter.hpp"
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+namespace // anonymous namespace
+{
+
+uint16_t constexpr phaseMask = SubsecondCounter::countsPerSecond - 1;
+static_assert(0 == (SubsecondCounter::countsPerSecond & phaseMask), "The 16 bit counter has to wrap at a multiple of a second.");
+
+// [0, countsPerSecond) -> [-countsPerSecond/2, countsPerSecond/2)
+int16_t symmetrizePhase(uint16_t const phase)
+{
+    return (SubsecondCounter::countsPerSecond / 2 > phase) ?
+                static_cast<int16_t>(phase) :
+                static_cast<int16_t>(phase) - static_cast<int16_t>(SubsecondCounter::countsPerSecond);
+}
+
+} // anonymous namespace
+
+namespace SubsecondCounter
+{
+
+void initialize()
+{
+    DDRD &= ~_BV(DDD5);
+    PORTD |= _BV(PORTD5);
+
+    TCCR1A = 0;
+    TCCR1B = _BV(CS12) | _BV(CS11) | _BV(CS10); // external clock on T1, rising edge
+    TIMSK1 = 0;
+}
+
+uint16_t count()
+{
+    uint16_t value = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        value = TCNT1;
+    }
+    return value;
+}
+
+void SecondPhase::narrow(uint16_t const windowStartCount, uint16_t const windowEndCount)
+{
+    uint16_t const start = windowStartCount & phaseMask;
+    uint16_t const length = (windowEndCount - windowStartCount) & phaseMask;
+
+    if (valid)
+    {
+        // Intersect in coordinates relative to the current window.
+        int16_t const offset = symmetrizePhase((start - windowStart) & phaseMask);
+        int16_t const lower = (0 > offset) ? 0 : offset;
+        int16_t const upper = (static_cast<int16_t>(windowLength) < offset + static_cast<int16_t>(length)) ?
+                    static_cast<int16_t>(windowLength) : (offset + static_cast<int16_t>(length));
+        if (lower <= upper)
+        {
+            windowStart = (windowStart + lower) & phaseMask;
+            windowLength = upper - lower;
+            return;
+        }
+        // Disjoint - the RTC has been set in between, start over.
+    }
+
+    windowStart = start;
+    windowLength = length;
+    valid = true;
+}
+
+uint16_t SecondPhase::update(uint16_t const countBeforeRead, uint16_t const countAfterRead, bool const secondChanged, bool const secondAdvanced)
+{
+    if (secondChanged)
+    {
+        if (secondAdvanced && previousCountValid)
+        {
+            narrow(previousCountBeforeRead, countAfterRead);
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    previousCountBeforeRead = countBeforeRead;
+    previousCountValid = true;
+
+    uint16_t phase = 0;
+    if (valid)
+    {
+        phase = (countAfterRead - (windowStart + windowLength / 2)) & phaseMask;
+        // Keep the phase consistent with the seconds read while the boundary is not exactly known.
+        if (secondChanged)
+        {
+            if (countsPerSecond / 2 <= phase)
+            {
+                phase = 0; // boundary estimate is later than the actual one
+            }
+        }
+        else if (phase < previousPhase)
+        {
+            phase = phaseMask; // boundary estimate is earlier than the actual one - hold at the end of the second
+        }
+    }
+    previousPhase = phase;
+    return phase;
+}
+
+} // namespace SubsecondCounter
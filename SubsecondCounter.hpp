@@ -0,0 +1,65 @@
+#ifndef SUBSECONDCOUNTER_HPP
+#define SUBSECONDCOUNTER_HPP
+
+#include <stdint.h>
+
+/**
+ * Crystal accurate subseconds: Timer1 counts the DS3231's 32.768 kHz output on its
+ * external clock input T1 [PD5, D5 - the 32K output is open drain, the internal pull-up is used].
+ * The counter runs without any CPU involvement, the phase of the RTC's second boundary
+ * within the counter is learned from the RTC reads that are done anyway.
+ */
+namespace SubsecondCounter
+{
+
+uint16_t constexpr countsPerSecond = 32768;
+
+void initialize();
+
+// Current counter value [wraps around every 2 seconds].
+uint16_t count();
+
+/**
+ * @brief The SecondPhase class Phase of the RTC's second boundary relative to the counter.
+ * Whenever the RTC's seconds advance between two reads, the boundary lies between the counts
+ * taken before the previous read and after the current one. As the reads are not in sync with
+ * the RTC, intersecting these windows over several seconds narrows the boundary down to
+ * about the duration of one read.
+ */
+class SecondPhase
+{
+public:
+    void reset()
+    {
+        previousCountValid = false;
+        valid = false;
+        previousPhase = 0;
+    }
+
+    /**
+     * @brief update Call once per RTC read.
+     * @param countBeforeRead count() right before reading the time from the RTC
+     * @param countAfterRead count() right after reading the time from the RTC
+     * @param secondChanged the seconds read differ from the previous read
+     * @param secondAdvanced the seconds read are exactly one after the previous read
+     * @return counts since the RTC's last second boundary in [0, countsPerSecond), 0 until the phase is known
+     */
+    uint16_t update(uint16_t const countBeforeRead, uint16_t const countAfterRead, bool const secondChanged, bool const secondAdvanced);
+
+private:
+    void narrow(uint16_t const windowStartCount, uint16_t const windowEndCount);
+
+    uint16_t previousCountBeforeRead = 0;
+    bool previousCountValid = false;
+
+    // boundary is in [windowStart, windowStart + windowLength] [modulo countsPerSecond]
+    uint16_t windowStart = 0;
+    uint16_t windowLength = 0;
+    bool valid = false;
+
+    uint16_t previousPhase = 0;
+};
+
+} // namespace SubsecondCounter
+
+#endif // SUBSECONDCOUNTER_HPP
@@ -0,0 +1,86 @@
+#include "Trace.hpp"
+
+namespace // anonymous namespace
+{
+
+void writeHeader(Stream & stream, char const * const magic)
+{
+    stream.write(reinterpret_cast<uint8_t const *>(magic), 4);
+    stream.write(Trace::version);
+}
+
+void writeUint16(Stream & stream, uint16_t const value)
+{
+    stream.write(static_cast<uint8_t>(value));
+    stream.write(static_cast<uint8_t>(value >> 8));
+}
+
+} // anonymous namespace
+
+namespace Trace
+{
+
+Recorder recorder;
+Player player;
+
+void Recorder::begin(Stream & stream)
+{
+    writeHeader(stream, "RCTR");
+}
+
+void Recorder::beginFrame(unsigned long const now)
+{
+    record.flags = 0;
+    unsigned long const delta = started ? (now - previousFrameTime) : 0;
+    record.millisDelta = (0xffff < delta) ? 0xffff : static_cast<uint16_t>(delta);
+    previousFrameTime = now;
+    started = true;
+}
+
+void Recorder::setTime(uint8_t const hours, uint8_t const minutes, uint8_t const seconds)
+{
+    record.flags |= flagTimeRead;
+    record.hours = hours;
+    record.minutes = minutes;
+    record.seconds = seconds;
+}
+
+void Recorder::endFrame(Stream & stream)
+{
+    stream.write(reinterpret_cast<uint8_t const *>(&record), sizeof(Record));
+}
+
+void Player::begin(Stream & stream)
+{
+    writeHeader(stream, "RCTP");
+}
+
+void Player::beginFrame(Stream & stream)
+{
+    while (static_cast<int>(sizeof(Record)) > stream.available())
+    {
+        // wait for the host
+    }
+    uint8_t * const bytes = reinterpret_cast<uint8_t *>(&record);
+    for (uint8_t i = 0; i < sizeof(Record); ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(stream.read());
+    }
+
+    frameTime += record.millisDelta;
+    if (0 != (record.flags & flagTimeRead))
+    {
+        time = record;
+    }
+}
+
+void Player::endFrame(Stream & stream, bool const shown, uint16_t const micros, uint8_t const * const pixels, uint16_t const byteCount)
+{
+    stream.write('F');
+    stream.write(shown ? 1 : 0);
+    writeUint16(stream, micros);
+    writeUint16(stream, byteCount);
+    stream.write(pixels, byteCount);
+}
+
+} // namespace Trace
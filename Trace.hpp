@@ -0,0 +1,137 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <Arduino.h>
+
+#include "ArduinoDrivers/simplePinAvr.hpp"
+
+/**
+ * Deterministic record/replay of the inputs of the state machine.
+ *
+ * Recording [debug build, TRACE_RECORD] writes per loop() cycle what the firmware read:
+ * the 4 buttons, the time read from the RTC and millis(). Replaying [TRACE_REPLAY] feeds
+ * these back to the unmodified state machine and answers every frame with the resulting
+ * pixels and the time the frame took. See tools/trace.py for the host side.
+ *
+ * Stream format [little endian]:
+ *  recording: "RCTR", version, then one Record per frame.
+ *  replay: device sends "RCTP", version once, then host sends one Record per frame and the
+ *          device answers with 'F', shown [0/1], micros [uint16], byteCount [uint16], pixels.
+ */
+namespace Trace
+{
+
+uint8_t constexpr version = 1;
+
+uint8_t constexpr flagTimeRead = 0x01;
+
+struct Record
+{
+    uint8_t buttonsDown = 0;    // bit i set: Buttons<i> is down
+    uint8_t flags = 0;          // flagTimeRead: hours, minutes and seconds were read from the RTC in this frame
+    uint8_t hours = 0;
+    uint8_t minutes = 0;
+    uint8_t seconds = 0;
+    uint16_t millisDelta = 0;   // millis() since the previous frame
+} __attribute__((packed));
+
+static_assert(7 == sizeof(Record), "Record is part of the trace format.");
+
+class Recorder
+{
+public:
+    void begin(Stream & stream);
+
+    void beginFrame(unsigned long const now);
+
+    void setButtonsDown(uint8_t const buttonsDown)
+    {
+        record.buttonsDown = buttonsDown;
+    }
+
+    void setTime(uint8_t const hours, uint8_t const minutes, uint8_t const seconds);
+
+    void endFrame(Stream & stream);
+
+private:
+    Record record;
+    unsigned long previousFrameTime = 0;
+    bool started = false;
+};
+
+class Player
+{
+public:
+    void begin(Stream & stream);
+
+    // Blocks until the next record was received.
+    void beginFrame(Stream & stream);
+
+    void endFrame(Stream & stream, bool const shown, uint16_t const micros, uint8_t const * const pixels, uint16_t const byteCount);
+
+    unsigned long now() const
+    {
+        return frameTime;
+    }
+
+    bool isButtonDown(uint8_t const index) const
+    {
+        return 0 != (record.buttonsDown & (1 << index));
+    }
+
+    // The time recorded last - also for frames in which the recording did not read it.
+    uint8_t hours() const
+    {
+        return time.hours;
+    }
+
+    uint8_t minutes() const
+    {
+        return time.minutes;
+    }
+
+    uint8_t seconds() const
+    {
+        return time.seconds;
+    }
+
+private:
+    Record record;
+    Record time;
+    unsigned long frameTime = 0;
+};
+
+extern Recorder recorder;
+extern Player player;
+
+/**
+ * Replaces a button's SimplePinAvrRead in replay builds - reads the recorded state of Buttons<index>.
+ * The buttons are active low.
+ */
+template<uint8_t index>
+struct ReplayPin
+{
+    static void initialize()
+    {
+        // intentionally empty
+    }
+
+    static SimplePin::State get()
+    {
+        return player.isButtonDown(index) ? SimplePin::State::Zero : SimplePin::State::One;
+    }
+
+    static bool isHigh()
+    {
+        return (SimplePin::State::One == get());
+    }
+
+    static bool isLow()
+    {
+        return (SimplePin::State::Zero == get());
+    }
+};
+
+} // namespace Trace
+
+#endif // TRACE_HPP
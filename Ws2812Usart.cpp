@@ -0,0 +1,127 @@
+#include "Ws2812Usart.hpp"
+
+#include <Arduino.h>
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+namespace // anonymous namespace
+{
+
+unsigned long constexpr spiBitRate = 4000000;
+static_assert(0 == (F_CPU % (2 * spiBitRate)), "SPI bit rate not achievable with this F_CPU.");
+uint16_t constexpr baudRateRegister = (F_CPU / (2 * spiBitRate)) - 1;
+
+// WS2812 latch [reset] time - newer parts need > 280 us.
+unsigned long constexpr latchMicros = 300;
+
+// Two WS2812 bits [MSB first] -> one SPI byte.
+uint8_t const encoding[4] = {0x88, 0x8E, 0xE8, 0xEE};
+
+volatile bool busy = false;
+volatile unsigned long completionTime = 0;
+
+void waitUntilDataRegisterEmpty()
+{
+    while (0 == (UCSR0A & _BV(UDRE0)))
+    {
+        // intentionally empty
+    }
+}
+
+// The upper two bits of value.
+void sendBitPair(uint8_t const value)
+{
+    waitUntilDataRegisterEmpty();
+    UDR0 = encoding[value >> 6];
+}
+
+} // anonymous namespace
+
+
+ISR(USART_TX_vect)
+{
+    // Release TxD - the pin falls back to its port value, i.e. low.
+    UCSR0B &= ~(_BV(TXCIE0) | _BV(TXEN0));
+    completionTime = micros();
+    busy = false;
+}
+
+
+namespace Ws2812Usart
+{
+
+void initialize()
+{
+    UBRR0 = 0;
+    // data low while idle, XCK as output to select master mode
+    PORTD &= ~_BV(PORTD1);
+    DDRD |= _BV(DDD1) | _BV(DDD4);
+    // MSPIM, MSB first, SPI mode 0
+    UCSR0C = _BV(UMSEL01) | _BV(UMSEL00);
+    UCSR0B = 0;
+    UBRR0 = baudRateRegister;
+}
+
+void show(uint8_t const * const data, uint16_t const byteCount)
+{
+    if (0 == byteCount)
+    {
+        return;
+    }
+
+    waitUntilIdle();
+    unsigned long completion = 0;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        completion = completionTime;
+    }
+    while ((micros() - completion) < latchMicros)
+    {
+        // wait for the WS2812s to latch the previous frame
+    }
+
+    busy = true;
+    UCSR0A = _BV(TXC0); // clear a stale transmit complete flag
+    UCSR0B = _BV(TXEN0);
+
+    // The USART buffers one byte besides the shift register - an ISR running in between
+    // only stretches the low phase at the end of a byte.
+    uint8_t const * const last = data + byteCount - 1;
+    for (uint8_t const * byte = data; byte != last; ++byte)
+    {
+        uint8_t const value = *byte;
+        sendBitPair(value);
+        sendBitPair(value << 2);
+        sendBitPair(value << 4);
+        sendBitPair(value << 6);
+    }
+    uint8_t const value = *last;
+    sendBitPair(value);
+    sendBitPair(value << 2);
+    sendBitPair(value << 4);
+    waitUntilDataRegisterEmpty();
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        // The transmitter may have run dry in between - only the last byte completes the frame.
+        UDR0 = encoding[value & 0b11];
+        UCSR0A = _BV(TXC0);
+        UCSR0B |= _BV(TXCIE0);
+    }
+}
+
+bool isBusy()
+{
+    return busy;
+}
+
+void waitUntilIdle()
+{
+    while (busy)
+    {
+        // intentionally empty
+    }
+}
+
+} // namespace Ws2812Usart
@@ -0,0 +1,41 @@
+#ifndef WS2812USART_HPP
+#define WS2812USART_HPP
+
+#include <stdint.h>
+
+/**
+ * WS2812 output via USART0 in master SPI mode [MSPIM], fed by polling the data register empty flag.
+ * In contrast to Adafruit_NeoPixel::show() interrupts stay enabled while the frame is sent.
+ * Not fed from the data register empty interrupt: at 8 MHz it would be due every 16 CPU cycles
+ * [one SPI byte at 4 MHz], less than its entry and exit alone take - loop() would starve and
+ * every other ISR would wait behind it. The polled loop leaves the ISRs the CPU between its writes.
+ *
+ * Pins [ATmega328P]:
+ *  - TXD0 [PD1, D1] - data out to the first WS2812,
+ *  - XCK0 [PD4, D4] - SPI clock, has to be an output for master mode, leave unconnected.
+ * Hence this can't be combined with Serial.
+ *
+ * Encoding: At 4 MHz SPI clock each WS2812 bit is sent as 4 SPI bits [0: 1000, 1: 1110], i.e. a 1 us
+ * bit period with T0H 250 ns and T1H 750 ns [WS2812B: T0H 400 ns +-150 ns, T1H 800 ns +-150 ns,
+ * period 1.25 us +-600 ns]. UBRR0 is 0 at 8 MHz - the fastest the USART gets.
+ * Every SPI byte carries 2 WS2812 bits and ends with a low bit. So a late refill of
+ * the data register [e.g. while another ISR runs] only stretches a low phase, which the
+ * WS2812 tolerates well below its reset time.
+ */
+namespace Ws2812Usart
+{
+
+void initialize();
+
+// Send byteCount bytes [in wire order, e.g. Adafruit_NeoPixel::getPixels()] - returns when the last one is in the
+// USART [about 8 us per byte], data may be modified then. Waits for a previous frame and its latch time.
+void show(uint8_t const * const data, uint16_t const byteCount);
+
+// Until the last bits have been shifted out.
+bool isBusy();
+
+void waitUntilIdle();
+
+} // namespace Ws2812Usart
+
+#endif // WS2812USART_HPP
@@ -1,12 +1,5 @@
-// For the Arduino IDE I can't specify additional include paths and
-// I did not want to create a public library but instead have the code
-// directly in the local repo - so assume helpers is added as a submodule
-// in this directory.
-#include "helpers/crc16.hpp"
-
-// todo: Make helpers a submodule of this submodule and adapt all includes of helpers... Either directly or via this...
-
 #include <avr/eeprom.h>
+#include <avr/pgmspace.h>
 
 #include <stdint.h>
 
@@ -18,6 +11,29 @@ namespace Eeprom
 
 typedef size_t Address;
 
+/**
+ * CRC-16/IBM-3740 [polynomial 0x1021, initial value 0xffff, not reflected], i.e. the same
+ * checksum as Crc16Ibm3740 from helpers - but table driven with one nibble at a time.
+ * The 16 entries table costs 32 bytes of flash and replaces the 8 shift/xor steps per byte
+ * of the bitwise implementation with 2 lookups.
+ */
+uint16_t const crc16Ibm3740NibbleTable[16] PROGMEM =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+    0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+uint16_t crc16Ibm3740(uint8_t const * const data, size_t const byteCount)
+{
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < byteCount; ++i)
+    {
+        crc = (crc << 4) ^ pgm_read_word(&crc16Ibm3740NibbleTable[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (crc << 4) ^ pgm_read_word(&crc16Ibm3740NibbleTable[(crc >> 12) ^ (data[i] & 0x0f)]);
+    }
+    return crc;
+}
+
 template <typename BACKUP_DATA, Address offset>
 constexpr bool fitsInEeprom()
 {
@@ -25,14 +41,13 @@ constexpr bool fitsInEeprom()
 }
 
 
+// Only bytes which differ are written - each write takes about 3.4 ms and wears the cell.
 void writeWithCrc(void const * const data, size_t const byteCount, Address const eepromAddress)
 {
-    Crc16Ibm3740 crc;
-    crc.process(static_cast<uint8_t const *>(data), byteCount);
-    uint16_t const crcValue = crc.get();
+    uint16_t const crcValue = crc16Ibm3740(static_cast<uint8_t const *>(data), byteCount);
 
-    eeprom_write_block(data, (void *)(eepromAddress), byteCount);
-    eeprom_write_block(&crcValue, (void *)(eepromAddress + byteCount), 2);
+    eeprom_update_block(data, (void *)(eepromAddress), byteCount);
+    eeprom_update_block(&crcValue, (void *)(eepromAddress + byteCount), 2);
 }
 
 
@@ -43,10 +58,7 @@ bool readWithCrc(void * const data, size_t const byteCount, Address const eeprom
     eeprom_read_block(data, (void const *)(eepromAddress), byteCount);
     eeprom_read_block(&crcValue, (void const *)(eepromAddress + byteCount), 2);
 
-    Crc16Ibm3740 crc;
-    crc.process(static_cast<uint8_t const *>(data), byteCount);
-
-    return (crc.get() == crcValue);
+    return (crc16Ibm3740(static_cast<uint8_t const *>(data), byteCount) == crcValue);
 }
 
 
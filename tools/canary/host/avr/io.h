@@ -0,0 +1,11 @@
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+// Host replacement - the stack pointer as a plain variable [defined by main.cpp], wide enough to
+// point into the test's fake SRAM.
+
+#include <stdint.h>
+
+extern volatile uintptr_t SP;
+
+#endif // AVR_IO_H
@@ -0,0 +1,234 @@
+// Host test of Memory's SRAM headroom monitoring - a fake ATmega328P SRAM, painted like .init3 does,
+// with a heap growing up from the static data and a stack growing down from RAMEND.
+//
+//     canary
+//
+// Checks that currentFreeBytes() follows the heap top and the stack pointer, that minimumFreeBytes()
+// is the high-water mark of both [deepest stack use since boot, highest heap top] and stays put when
+// the stack unwinds, that both agree while the stack is at its deepest, and that heapTop() is the
+// address of the first byte above the heap.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <avr/io.h>
+
+#include "Memory.hpp"
+
+volatile uintptr_t SP;
+
+extern "C" uint8_t _end;
+extern "C" char * __brkval;
+extern "C" char * __malloc_heap_start;
+
+uint8_t _end;
+char * __brkval;
+char * __malloc_heap_start;
+
+namespace // anonymous namespace
+{
+
+uint16_t constexpr sramSize = 2048;
+// .data and .bss of a typical build.
+uint16_t constexpr staticDataSize = 600;
+
+struct Check
+{
+    std::string name;
+    bool passed = true;
+
+    explicit Check(std::string const & name)
+        : name(name)
+    {
+        // intentionally empty
+    }
+
+    void expect(char const * const what, long const actual, long const expected)
+    {
+        if (actual != expected)
+        {
+            std::printf("%s: %s is %ld, expected %ld\n", name.c_str(), what, actual, expected);
+            passed = false;
+        }
+    }
+
+    void report() const
+    {
+        std::printf("%-48s %s\n", name.c_str(), passed ? "pass" : "FAIL");
+    }
+};
+
+// The SRAM from the end of the static data to RAMEND.
+struct Sram
+{
+    uint8_t bytes[sramSize];
+    uint8_t * const staticDataEnd = bytes + staticDataSize;
+    uint8_t * const ramEnd = bytes + sramSize - 1;
+
+    // Like .init3 and avr-libc's startup: paint up to the stack pointer, no heap yet.
+    Sram()
+    {
+        std::memset(bytes, 0, sizeof(bytes));
+        SP = reinterpret_cast<uintptr_t>(ramEnd);
+        __malloc_heap_start = reinterpret_cast<char *>(staticDataEnd);
+        __brkval = nullptr;
+        std::memset(staticDataEnd, Memory::canary, ramEnd - staticDataEnd + 1);
+    }
+
+    uint8_t * stackPointer() const
+    {
+        return reinterpret_cast<uint8_t *>(SP);
+    }
+
+    uint8_t * heapTop() const
+    {
+        return reinterpret_cast<uint8_t *>((nullptr != __brkval) ? __brkval : __malloc_heap_start);
+    }
+
+    // Free bytes from the heap top up to and including the byte SP points at.
+    long freeBytes() const
+    {
+        return stackPointer() - heapTop() + 1;
+    }
+
+    // A push stores at SP, then decrements it - frames hold data, return addresses, saved registers.
+    void push(uint16_t const byteCount, uint8_t const value = 0x42)
+    {
+        for (uint16_t i = 0; i < byteCount; ++i)
+        {
+            *stackPointer() = value;
+            SP = SP - 1;
+        }
+    }
+
+    // The popped bytes keep their values, as on the device.
+    void pop(uint16_t const byteCount)
+    {
+        SP = SP + byteCount;
+    }
+
+    // malloc() moving __brkval up, the block used.
+    void allocate(uint16_t const byteCount)
+    {
+        uint8_t * const top = heapTop();
+        std::memset(top, 0x17, byteCount);
+        __brkval = reinterpret_cast<char *>(top + byteCount);
+    }
+};
+
+Check checkBoot()
+{
+    Check check("after boot everything is free");
+    Sram sram;
+    check.expect("currentFreeBytes()", Memory::currentFreeBytes(), sramSize - staticDataSize);
+    check.expect("minimumFreeBytes()", Memory::minimumFreeBytes(), sramSize - staticDataSize);
+    check.expect("heapTop()", Memory::heapTop(), static_cast<uint16_t>(reinterpret_cast<uintptr_t>(sram.staticDataEnd)));
+    return check;
+}
+
+Check checkStackHighWaterMark()
+{
+    Check check("deepest stack use is kept after unwinding");
+    Sram sram;
+    long const freeAtBoot = sram.freeBytes();
+
+    // main() and loop() frames stay.
+    sram.push(40);
+    check.expect("currentFreeBytes() with frames", Memory::currentFreeBytes(), freeAtBoot - 40);
+
+    // A deep call chain with an ISR on top, then back.
+    sram.push(300);
+    sram.push(25);
+    check.expect("currentFreeBytes() at the deepest", Memory::currentFreeBytes(), freeAtBoot - 365);
+    check.expect("minimumFreeBytes() at the deepest", Memory::minimumFreeBytes(), Memory::currentFreeBytes());
+    sram.pop(325);
+    check.expect("currentFreeBytes() after unwinding", Memory::currentFreeBytes(), freeAtBoot - 40);
+    check.expect("minimumFreeBytes() after unwinding", Memory::minimumFreeBytes(), freeAtBoot - 365);
+
+    // Shallower calls later do not raise the mark, deeper ones lower it.
+    sram.push(100);
+    sram.pop(100);
+    check.expect("minimumFreeBytes() after a shallower call", Memory::minimumFreeBytes(), freeAtBoot - 365);
+    sram.push(500);
+    sram.pop(500);
+    check.expect("minimumFreeBytes() after a deeper call", Memory::minimumFreeBytes(), freeAtBoot - 540);
+    return check;
+}
+
+Check checkHeap()
+{
+    Check check("heap growth counts against both");
+    Sram sram;
+    long const freeAtBoot = sram.freeBytes();
+    sram.push(60);
+    sram.pop(60);
+
+    // Adafruit_NeoPixel allocates its pixel buffer in its constructor.
+    sram.allocate(180);
+    check.expect("heapTop()", Memory::heapTop(), static_cast<uint16_t>(reinterpret_cast<uintptr_t>(sram.staticDataEnd + 180)));
+    check.expect("currentFreeBytes()", Memory::currentFreeBytes(), freeAtBoot - 180);
+    check.expect("minimumFreeBytes()", Memory::minimumFreeBytes(), freeAtBoot - 180 - 60);
+
+    sram.allocate(20);
+    sram.push(30);
+    check.expect("currentFreeBytes() with a frame", Memory::currentFreeBytes(), freeAtBoot - 200 - 30);
+    check.expect("minimumFreeBytes() with a frame", Memory::minimumFreeBytes(), freeAtBoot - 200 - 60);
+    return check;
+}
+
+Check checkExhausted()
+{
+    Check check("stack down to the heap top");
+    Sram sram;
+    sram.allocate(100);
+    long const freeBytes = sram.freeBytes();
+    // SP ends on the heap top itself - its byte is still free.
+    sram.push(static_cast<uint16_t>(freeBytes - 1));
+    check.expect("currentFreeBytes()", Memory::currentFreeBytes(), 1);
+    check.expect("minimumFreeBytes()", Memory::minimumFreeBytes(), 1);
+    sram.pop(static_cast<uint16_t>(freeBytes - 1));
+    check.expect("minimumFreeBytes() after unwinding", Memory::minimumFreeBytes(), 1);
+    return check;
+}
+
+// The documented limitation: data equal to the canary at the deepest position reads as unused.
+Check checkCanaryValuedData()
+{
+    Check check("canary valued stack data is optimistic");
+    Sram sram;
+    long const freeAtBoot = sram.freeBytes();
+    sram.push(50);
+    sram.push(3, Memory::canary);
+    sram.pop(53);
+    check.expect("minimumFreeBytes()", Memory::minimumFreeBytes(), freeAtBoot - 50);
+    return check;
+}
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    if (1 < argc)
+    {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    Check const checks[] = {
+        checkBoot(),
+        checkStackHighWaterMark(),
+        checkHeap(),
+        checkExhausted(),
+        checkCanaryValuedData(),
+    };
+
+    bool passed = true;
+    for (Check const & check : checks)
+    {
+        check.report();
+        passed = passed && check.passed;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Host side of the serial commands of a SERIAL_COMMANDS build [see SerialCommands.hpp].
+
+time: set the RTC - to the host's local time without an argument.
+    configure.py COM5 time
+    configure.py COM5 time 13:45:00
+color / brightness / kernel: set a hand [hours, minutes or seconds].
+    configure.py COM5 color seconds 0 255
+    configure.py COM5 brightness minutes 64
+    configure.py COM5 kernel hours 0
+event: add an event [EVENTS_FROM_RTC_ALARMS builds], erase one by its index in the dump or all of them.
+    configure.py COM5 event add 6:45 wake
+    configure.py COM5 event erase 0
+    configure.py COM5 event erase
+chime: switch the hourly chime on or off.
+    configure.py COM5 chime off
+trail: set the seconds hand's trail - length [0: off], hue and saturation.
+    configure.py COM5 trail 8 32 255
+offset: set the index of a ring's 12 o'clock pixel [ring 0: inner].
+    configure.py COM5 offset 1 30
+budget: set the current budget of the LEDs in mA.
+    configure.py COM5 budget 400
+dump: print all settings but the time as a script [to stdout or a file].
+    configure.py COM5 dump clock1.txt
+script: send the commands of a script line by line, e.g. a dump of another clock.
+    configure.py COM6 script clock1.txt
+A color closer to another hand's than the buttons allow is rejected - a script swapping two hands'
+colors has to pass through a third one.
+telemetry: print current, memory [and ambient light] readings.
+    configure.py COM5 telemetry
+"""
+
+import argparse
+import datetime
+import sys
+import time
+
+import serial
+
+BAUDRATE = 57600
+COMPONENTS = {'hours': 0, 'minutes': 1, 'seconds': 2}
+# Events::EventType
+EVENT_TYPES = {'wake': 0, 'night-start': 1, 'night-end': 2}
+# Opening the port resets the board - wait for setup() to finish.
+BOOT_TIME_S = 2.5
+# Colors, brightness, kernels, trail, offsets and budget go to EEPROM 2 s after the last command
+# [serialSettingsStoreDelayMs] - the port stays open until then, the next run would reset the board.
+STORE_DELAY_S = 2.5
+
+
+def execute(port, line, names=None):
+    """Send one command, return the lines of its answer - those starting with the command's letter or one of names.
+    Other output [PRINT_SERIAL_* builds] is skipped."""
+    port.write((line.strip() + '\n').encode('ascii'))
+    names = names if names is not None else line.strip()[:1].upper()
+    answer = []
+    while True:
+        reply = port.readline().decode('ascii', errors='replace').strip()
+        if not reply:
+            raise RuntimeError('timeout - no answer to "{}"'.format(line.strip()))
+        if 'OK' == reply:
+            return answer
+        if 'ERR' == reply:
+            raise RuntimeError('rejected: "{}"'.format(line.strip()))
+        if reply[:1] in names and (reply[1:2] in ('', ' ')):
+            answer.append(reply)
+
+
+def open_port(args):
+    port = serial.Serial(args.port, BAUDRATE, timeout=2)
+    time.sleep(BOOT_TIME_S)
+    port.reset_input_buffer()
+    return port
+
+
+def set_time(port, args):
+    if args.time is None:
+        now = datetime.datetime.now()
+        # Aim for the start of the next second.
+        time.sleep(1. - now.microsecond / 1e6)
+        now = datetime.datetime.now()
+        hours, minutes, seconds = now.hour, now.minute, now.second
+    else:
+        hours, minutes, seconds = (int(field) for field in args.time.split(':'))
+    execute(port, 'T {} {} {}'.format(hours, minutes, seconds))
+
+
+def color(port, args):
+    execute(port, 'C {} {} {}'.format(COMPONENTS[args.component], args.hue, args.saturation))
+
+
+def brightness(port, args):
+    execute(port, 'B {} {}'.format(COMPONENTS[args.component], args.brightness))
+
+
+def kernel(port, args):
+    execute(port, 'K {} {}'.format(COMPONENTS[args.component], args.kernel))
+
+
+def event(port, args):
+    if 'add' == args.action:
+        if args.time is None or args.type is None:
+            raise RuntimeError('add needs a time and a type')
+        hours, minutes = (int(field) for field in args.time.split(':'))
+        execute(port, 'A {} {} {}'.format(hours, minutes, EVENT_TYPES[args.type]))
+    elif args.time is None:
+        execute(port, 'E')
+    else:
+        execute(port, 'E {}'.format(int(args.time)))
+
+
+def chime(port, args):
+    execute(port, 'H {}'.format(1 if 'on' == args.state else 0))
+
+
+def trail(port, args):
+    execute(port, 'L {} {} {}'.format(args.length, args.hue, args.saturation))
+
+
+def offset(port, args):
+    execute(port, 'O {} {}'.format(args.ring, args.offset))
+
+
+def budget(port, args):
+    execute(port, 'M {}'.format(args.milliamps))
+
+
+def dump(port, args):
+    # The lines of the dump are commands of their own - they do not start with D.
+    lines = execute(port, 'D', names='CBKLOMEAH')
+    if args.file is None:
+        print('\n'.join(lines))
+    else:
+        with open(args.file, 'w') as script:
+            script.write('\n'.join(lines) + '\n')
+
+
+def script(port, args):
+    with open(args.file, 'r') as commands:
+        for line in commands:
+            if line.strip() and not line.startswith('#'):
+                execute(port, line)
+
+
+def telemetry(port, args):
+    for line in execute(port, 'R'):
+        print(line[2:])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('port')
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    parser_time = commands.add_parser('time')
+    parser_time.add_argument('time', nargs='?', help='HH:MM:SS')
+    parser_time.set_defaults(function=set_time)
+
+    parser_color = commands.add_parser('color')
+    parser_color.add_argument('component', choices=COMPONENTS)
+    parser_color.add_argument('hue', type=int)
+    parser_color.add_argument('saturation', type=int)
+    parser_color.set_defaults(function=color)
+
+    parser_brightness = commands.add_parser('brightness')
+    parser_brightness.add_argument('component', choices=COMPONENTS)
+    parser_brightness.add_argument('brightness', type=int)
+    parser_brightness.set_defaults(function=brightness)
+
+    parser_kernel = commands.add_parser('kernel')
+    parser_kernel.add_argument('component', choices=COMPONENTS)
+    parser_kernel.add_argument('kernel', type=int, help='index of ClockFace::SelectableKernel')
+    parser_kernel.set_defaults(function=kernel)
+
+    parser_event = commands.add_parser('event')
+    parser_event.add_argument('action', choices=['add', 'erase'])
+    parser_event.add_argument('time', nargs='?', help='HH:MM to add, the index to erase [all without]')
+    parser_event.add_argument('type', nargs='?', choices=EVENT_TYPES)
+    parser_event.set_defaults(function=event)
+
+    parser_chime = commands.add_parser('chime')
+    parser_chime.add_argument('state', choices=['on', 'off'])
+    parser_chime.set_defaults(function=chime)
+
+    parser_trail = commands.add_parser('trail')
+    parser_trail.add_argument('length', type=int)
+    parser_trail.add_argument('hue', type=int)
+    parser_trail.add_argument('saturation', type=int)
+    parser_trail.set_defaults(function=trail)
+
+    parser_offset = commands.add_parser('offset')
+    parser_offset.add_argument('ring', type=int)
+    parser_offset.add_argument('offset', type=int)
+    parser_offset.set_defaults(function=offset)
+
+    parser_budget = commands.add_parser('budget')
+    parser_budget.add_argument('milliamps', type=int)
+    parser_budget.set_defaults(function=budget)
+
+    parser_dump = commands.add_parser('dump')
+    parser_dump.add_argument('file', nargs='?')
+    parser_dump.set_defaults(function=dump)
+
+    parser_script = commands.add_parser('script')
+    parser_script.add_argument('file')
+    parser_script.set_defaults(function=script)
+
+    parser_telemetry = commands.add_parser('telemetry')
+    parser_telemetry.set_defaults(function=telemetry)
+
+    args = parser.parse_args()
+    with open_port(args) as port:
+        try:
+            args.function(port, args)
+        except RuntimeError as error:
+            print(error, file=sys.stderr)
+            sys.exit(1)
+        finally:
+            if args.function in (color, brightness, kernel, trail, offset, budget, script):
+                time.sleep(STORE_DELAY_S)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,97 @@
+#ifndef ADAFRUIT_NEOPIXEL_H
+#define ADAFRUIT_NEOPIXEL_H
+
+// Host replacement of the parts of Adafruit_NeoPixel used by the firmware: a pixel buffer in the
+// order of the pixel type [RGB by default], show() and the brightness are left out.
+
+#include <stdint.h>
+#include <string.h>
+
+typedef uint16_t neoPixelType;
+
+// Byte offsets of red, green and blue as in the library.
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel
+{
+public:
+    static uint16_t constexpr maximumPixelCount = 256;
+
+    explicit Adafruit_NeoPixel(uint16_t const pixelCount, int16_t const pin = -1, neoPixelType const type = NEO_RGB)
+        : pixelCount((maximumPixelCount < pixelCount) ? maximumPixelCount : pixelCount)
+        , rOffset((type >> 4) & 0b11)
+        , gOffset((type >> 2) & 0b11)
+        , bOffset(type & 0b11)
+    {
+        (void)pin;
+        clear();
+    }
+
+    void begin()
+    {
+        // intentionally empty
+    }
+
+    void show()
+    {
+        // intentionally empty
+    }
+
+    void setBrightness(uint8_t const brightness)
+    {
+        (void)brightness;
+    }
+
+    uint16_t numPixels() const
+    {
+        return pixelCount;
+    }
+
+    void clear()
+    {
+        memset(pixels, 0, sizeof(pixels));
+    }
+
+    void setPixelColor(uint16_t const index, uint32_t const color)
+    {
+        if (index < pixelCount)
+        {
+            pixels[3 * index + rOffset] = static_cast<uint8_t>(color >> 16);
+            pixels[3 * index + gOffset] = static_cast<uint8_t>(color >> 8);
+            pixels[3 * index + bOffset] = static_cast<uint8_t>(color);
+        }
+    }
+
+    uint32_t getPixelColor(uint16_t const index) const
+    {
+        if (index >= pixelCount)
+        {
+            return 0;
+        }
+        return (static_cast<uint32_t>(pixels[3 * index + rOffset]) << 16)
+                | (static_cast<uint32_t>(pixels[3 * index + gOffset]) << 8)
+                | static_cast<uint32_t>(pixels[3 * index + bOffset]);
+    }
+
+    // In the order of the pixel type - RGB for the clock face renders, GRB like on the wire for the firmware's strips.
+    uint8_t * getPixels()
+    {
+        return pixels;
+    }
+
+    uint8_t const * getPixels() const
+    {
+        return pixels;
+    }
+
+private:
+    uint16_t pixelCount;
+    uint8_t rOffset;
+    uint8_t gOffset;
+    uint8_t bOffset;
+    uint8_t pixels[3 * maximumPixelCount];
+};
+
+#endif // ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,14 @@
+#ifndef AVR_PGMSPACE_H
+#define AVR_PGMSPACE_H
+
+// Host replacement - flash and RAM share one address space.
+
+#include <stdint.h>
+
+#define PROGMEM
+
+#define pgm_read_byte(address) (*reinterpret_cast<uint8_t const *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<uint16_t const *>(address))
+#define pgm_read_float(address) (*reinterpret_cast<float const *>(address))
+
+#endif // AVR_PGMSPACE_H
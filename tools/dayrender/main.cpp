@@ -0,0 +1,309 @@
+// Renders the clock face for every frame of a time range on all cores.
+//
+// Writes a frame file [see writeFrameFile()] and optionally one PPM image strip per hour,
+// each row one frame [sampled], each ring pixel a block of stripPixelWidth image pixels.
+//
+// Usage: dayrender [options]
+//   --start HH:MM:SS          first frame [default 00:00:00]
+//   --duration SECONDS        [default 86400]
+//   --fps FRAMES              frames per second [default 20 - the firmware's 50 ms cycle]
+//   --pixels COUNT            ring size [default 12]
+//   --threads COUNT           [default: all cores]
+//   --output FILE             frame file [default frames.rcdf]
+//   --strips PREFIX           write PREFIX_HH.ppm image strips
+//   --strip-rows-per-second N [default 1]
+//   --renderer NAME           footprint [the firmware's, default] or analytic [the reference]
+//   --hours HUE,SATURATION,BRIGHTNESS,KERNEL    settings of a hand, the kernel by name
+//   --minutes ...
+//   --seconds ...
+
+#include "ClockFace.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+char const * const kernelNames[ClockFace::selectableKernelCount] = {
+    "delta",
+    "mountainNarrow",
+    "mountainWide",
+    "gaussianNarrow",
+    "gaussianWide",
+    "triangleNarrow",
+    "triangleWide",
+    "cosineNarrow",
+    "cosineWide",
+};
+
+uint8_t constexpr bytesPerPixel = 3;
+unsigned constexpr stripPixelWidth = 8;
+
+struct Options
+{
+    double startMs = 0.;
+    double durationS = 86400.;
+    unsigned fps = 20;
+    uint16_t pixelCount = 12;
+    unsigned threadCount = std::thread::hardware_concurrency();
+    std::string output = "frames.rcdf";
+    std::string stripsPrefix;
+    unsigned stripRowsPerSecond = 1;
+    bool analytic = false;
+    ClockFace::ColorsSettings colorsSettings;
+};
+
+[[noreturn]] void fail(std::string const & message)
+{
+    std::cerr << "dayrender: " << message << std::endl;
+    std::exit(1);
+}
+
+ClockFace::SelectableKernel parseKernel(std::string const & name)
+{
+    for (uint8_t i = 0; i < ClockFace::selectableKernelCount; ++i)
+    {
+        if (name == kernelNames[i])
+        {
+            return static_cast<ClockFace::SelectableKernel>(i);
+        }
+    }
+    fail("unknown kernel " + name);
+}
+
+ClockFace::ColorSettings parseColorSettings(std::string const & text)
+{
+    std::stringstream stream(text);
+    std::string fields[4];
+    for (std::string & field : fields)
+    {
+        if (!std::getline(stream, field, ','))
+        {
+            fail("expected HUE,SATURATION,BRIGHTNESS,KERNEL, got " + text);
+        }
+    }
+    ClockFace::ColorSettings colorSettings;
+    colorSettings.hueSaturation = ClockFace::HueSaturation(std::stoi(fields[0]), std::stoi(fields[1]));
+    colorSettings.brightness = std::stoi(fields[2]);
+    colorSettings.selectableKernel = parseKernel(fields[3]);
+    return colorSettings;
+}
+
+Options parseOptions(int const argc, char const * const * const argv)
+{
+    Options options;
+    // The firmware's defaults without a backup in EEPROM.
+    options.colorsSettings.at(ClockFace::DisplayComponent::hours) = parseColorSettings("168,255,200,delta");
+    options.colorsSettings.at(ClockFace::DisplayComponent::minutes) = parseColorSettings("88,255,200,mountainNarrow");
+    options.colorsSettings.at(ClockFace::DisplayComponent::seconds) = parseColorSettings("0,255,200,mountainNarrow");
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const option = argv[i];
+        if (argc <= i + 1)
+        {
+            fail("missing value for " + option);
+        }
+        std::string const value = argv[++i];
+
+        if ("--start" == option)
+        {
+            unsigned hours = 0;
+            unsigned minutes = 0;
+            unsigned seconds = 0;
+            if (3 != std::sscanf(value.c_str(), "%u:%u:%u", &hours, &minutes, &seconds))
+            {
+                fail("expected HH:MM:SS, got " + value);
+            }
+            options.startMs = ((hours * 60. + minutes) * 60. + seconds) * 1000.;
+        }
+        else if ("--duration" == option)
+        {
+            options.durationS = std::stod(value);
+        }
+        else if ("--fps" == option)
+        {
+            options.fps = std::stoul(value);
+        }
+        else if ("--pixels" == option)
+        {
+            options.pixelCount = std::stoul(value);
+        }
+        else if ("--threads" == option)
+        {
+            options.threadCount = std::stoul(value);
+        }
+        else if ("--output" == option)
+        {
+            options.output = value;
+        }
+        else if ("--strips" == option)
+        {
+            options.stripsPrefix = value;
+        }
+        else if ("--strip-rows-per-second" == option)
+        {
+            options.stripRowsPerSecond = std::stoul(value);
+        }
+        else if ("--renderer" == option)
+        {
+            if (("footprint" != value) && ("analytic" != value))
+            {
+                fail("unknown renderer " + value);
+            }
+            options.analytic = ("analytic" == value);
+        }
+        else if ("--hours" == option)
+        {
+            options.colorsSettings.at(ClockFace::DisplayComponent::hours) = parseColorSettings(value);
+        }
+        else if ("--minutes" == option)
+        {
+            options.colorsSettings.at(ClockFace::DisplayComponent::minutes) = parseColorSettings(value);
+        }
+        else if ("--seconds" == option)
+        {
+            options.colorsSettings.at(ClockFace::DisplayComponent::seconds) = parseColorSettings(value);
+        }
+        else
+        {
+            fail("unknown option " + option);
+        }
+    }
+
+    if ((0 == options.fps) || (0 == options.pixelCount) || (Adafruit_NeoPixel::maximumPixelCount < options.pixelCount))
+    {
+        fail("invalid fps or pixel count");
+    }
+    if (0 == options.threadCount)
+    {
+        options.threadCount = 1;
+    }
+    return options;
+}
+
+// Like the firmware: the RTC's seconds plus subseconds since the last second change.
+void renderFrame(Adafruit_NeoPixel & strip, double const timeMs, Options const & options)
+{
+    double const wholeSeconds = static_cast<double>(static_cast<uint64_t>(timeMs / 1000.));
+    uint32_t const secondsOfDay = static_cast<uint64_t>(wholeSeconds) % 86400;
+    ClockFace::TimeOfDay const timeOfDay(secondsOfDay / 3600, secondsOfDay / 60 % 60, secondsOfDay % 60);
+    double const subseconds = (timeMs - wholeSeconds * 1000.) / 1000.;
+    if (options.analytic)
+    {
+        ClockFace::composeTimeOfDayAnalytic(strip, timeOfDay, subseconds, options.colorsSettings);
+    }
+    else
+    {
+        ClockFace::composeTimeOfDay(strip, timeOfDay, subseconds, options.colorsSettings);
+    }
+}
+
+void renderFrames(Options const & options, uint64_t const firstFrame, uint64_t const endFrame, uint8_t * const frames)
+{
+    Adafruit_NeoPixel strip(options.pixelCount);
+    size_t const frameSize = options.pixelCount * bytesPerPixel;
+    for (uint64_t frame = firstFrame; frame < endFrame; ++frame)
+    {
+        renderFrame(strip, options.startMs + frame * 1000. / options.fps, options);
+        std::memcpy(frames + frame * frameSize, strip.getPixels(), frameSize);
+    }
+}
+
+void writeLittleEndian(std::ostream & stream, uint64_t const value, uint8_t const byteCount)
+{
+    for (uint8_t i = 0; i < byteCount; ++i)
+    {
+        stream.put(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+// "RCDF", version [1], bytes per pixel [3, RGB], pixel count [uint16], frame count [uint32],
+// start [ms of day, uint32], frames per second [uint16], then the frames.
+void writeFrameFile(Options const & options, uint64_t const frameCount, std::vector<uint8_t> const & frames)
+{
+    std::ofstream file(options.output, std::ios::binary);
+    file.write("RCDF", 4);
+    writeLittleEndian(file, 1, 1);
+    writeLittleEndian(file, bytesPerPixel, 1);
+    writeLittleEndian(file, options.pixelCount, 2);
+    writeLittleEndian(file, frameCount, 4);
+    writeLittleEndian(file, static_cast<uint64_t>(options.startMs), 4);
+    writeLittleEndian(file, options.fps, 2);
+    file.write(reinterpret_cast<char const *>(frames.data()), frames.size());
+    if (!file)
+    {
+        fail("writing " + options.output + " failed");
+    }
+}
+
+void writeStrips(Options const & options, uint64_t const frameCount, std::vector<uint8_t> const & frames)
+{
+    size_t const frameSize = options.pixelCount * bytesPerPixel;
+    uint64_t const framesPerRow = (options.fps > options.stripRowsPerSecond) ? (options.fps / options.stripRowsPerSecond) : 1;
+    uint64_t const framesPerStrip = static_cast<uint64_t>(options.fps) * 3600;
+    unsigned const width = options.pixelCount * stripPixelWidth;
+
+    for (uint64_t stripStart = 0; stripStart < frameCount; stripStart += framesPerStrip)
+    {
+        uint64_t const stripEnd = (frameCount < stripStart + framesPerStrip) ? frameCount : (stripStart + framesPerStrip);
+        uint64_t const rows = (stripEnd - stripStart + framesPerRow - 1) / framesPerRow;
+
+        unsigned const hour = static_cast<unsigned>((options.startMs + stripStart * 1000. / options.fps) / 3600000.) % 24;
+        char name[16];
+        std::snprintf(name, sizeof(name), "_%02u.ppm", hour);
+        std::ofstream file(options.stripsPrefix + name, std::ios::binary);
+        file << "P6\n" << width << " " << rows << "\n255\n";
+        for (uint64_t frame = stripStart; frame < stripEnd; frame += framesPerRow)
+        {
+            uint8_t const * const pixels = frames.data() + frame * frameSize;
+            for (unsigned i = 0; i < width; ++i)
+            {
+                file.write(reinterpret_cast<char const *>(pixels + (i / stripPixelWidth) * bytesPerPixel), bytesPerPixel);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    Options const options = parseOptions(argc, argv);
+
+    uint64_t const frameCount = static_cast<uint64_t>(options.durationS * options.fps);
+    std::vector<uint8_t> frames(frameCount * options.pixelCount * bytesPerPixel);
+
+    auto const startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < options.threadCount; ++t)
+    {
+        uint64_t const firstFrame = frameCount * t / options.threadCount;
+        uint64_t const endFrame = frameCount * (t + 1) / options.threadCount;
+        threads.emplace_back(renderFrames, std::cref(options), firstFrame, endFrame, frames.data());
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> const renderDuration = std::chrono::steady_clock::now() - startTime;
+
+    writeFrameFile(options, frameCount, frames);
+    if (!options.stripsPrefix.empty())
+    {
+        writeStrips(options, frameCount, frames);
+    }
+
+    std::cerr << "Rendered " << frameCount << " frames on " << options.threadCount << " threads in "
+              << renderDuration.count() << " s." << std::endl;
+    return 0;
+}
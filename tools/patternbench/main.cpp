@@ -0,0 +1,560 @@
+// Checks the firmware's color and rendering kernels against a double precision reference and times them.
+//
+// The checks sweep every input of the 8 bit color kernels and, for the renderers, positions across the
+// whole ring x all selectable kernels x hand brightnesses. Each result is compared per channel to the
+// exact value - the largest deviation has to stay within the tolerance documented next to the function.
+// The benchmarks time the optimized functions against the ones they replaced [host ns per operation,
+// the minimum of several runs - relative, not absolute, figures carry over to the ATmega].
+//
+// Usage: patternbench [--check] [--benchmark]    [default: both]
+// Exits with 1 if a tolerance is exceeded - ctest runs the checks.
+
+#include "ClockFace.hpp"
+#include "Colors.hpp"
+#include "Footprints.hpp"
+#include "NeoPixelPatterns.hpp"
+#include "RingArithmetic.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+char const * const kernelNames[ClockFace::selectableKernelCount] = {
+    "delta",
+    "mountainNarrow",
+    "mountainWide",
+    "gaussianNarrow",
+    "gaussianWide",
+    "triangleNarrow",
+    "triangleWide",
+    "cosineNarrow",
+    "cosineWide",
+};
+
+// Renderer sweeps: positions per pixel [prime, so the positions do not line up with the 64 footprint
+// phases - integer positions are included] and the step of the hand brightness per ring size [both reach 255].
+struct RingSweep
+{
+    uint16_t pixelCount;
+    unsigned positionsPerPixel;
+    unsigned brightnessStep;
+};
+
+RingSweep const ringSweeps[] = {
+    {12, 61, 3},
+    {60, 13, 5},
+};
+
+// Documented in Colors.hpp, NeoPixelPatterns.hpp and Footprints.hpp [ClockFace.cpp].
+double constexpr colorScaleToleranceLsb = 1.;
+double constexpr colorScaleBrightnessToleranceLsb = 1.;
+double constexpr addColorsToleranceLsb = 0.;
+double constexpr blendColorsToleranceLsb = 1.5;
+double constexpr colorFromHsvToleranceLsb = 2.;
+// Truncation by colorScaleBrightness().
+double constexpr analyticToleranceLsb = 1.;
+// 1.25 LSB of the footprint weights [at channel 255] plus the truncation by colorScale().
+double constexpr footprintToleranceLsb = 2.25;
+// Floating point noise - a product landing exactly on an integer may truncate to either side.
+double constexpr epsilonLsb = 1e-9;
+
+uint8_t channel(Colors::Color_t const color, uint8_t const shift)
+{
+    return static_cast<uint8_t>(color >> shift);
+}
+
+struct Check
+{
+    std::string name;
+    double toleranceLsb;
+    double maximumErrorLsb = 0.;
+    std::string worstCase;
+
+    Check(std::string const & name, double const toleranceLsb)
+        : name(name)
+        , toleranceLsb(toleranceLsb)
+    {
+        // intentionally empty
+    }
+
+    void compare(double const actual, double const exact, std::string const & where = std::string())
+    {
+        double const error = std::fabs(actual - exact);
+        if (maximumErrorLsb < error)
+        {
+            maximumErrorLsb = error;
+            worstCase = where;
+        }
+    }
+
+    bool passed() const
+    {
+        return maximumErrorLsb <= toleranceLsb + epsilonLsb;
+    }
+};
+
+double clamp255(double const value)
+{
+    return (255. < value) ? 255. : ((0. > value) ? 0. : value);
+}
+
+Check checkColorScale()
+{
+    Check check("colorScale", colorScaleToleranceLsb);
+    for (unsigned component = 0; component < 256; ++component)
+    {
+        for (unsigned factor = 0; factor < 256; ++factor)
+        {
+            Colors::Color_t const scaled = Colors::colorScale(Colors::Color(component, 0, 0), factor);
+            check.compare(channel(scaled, 16), component * factor / 255.);
+        }
+    }
+    return check;
+}
+
+Check checkColorScaleBrightness()
+{
+    Check check("colorScaleBrightness", colorScaleBrightnessToleranceLsb);
+    for (unsigned component = 0; component < 256; ++component)
+    {
+        // Including the clipped factors outside [0, 1].
+        for (int step = -512; step <= 2560; ++step)
+        {
+            double const factor = step / 2048.;
+            Colors::Color_t const scaled = Colors::colorScaleBrightness(Colors::Color(component, 0, 0), factor);
+            check.compare(channel(scaled, 16), clamp255(component * factor));
+        }
+    }
+    return check;
+}
+
+Check checkAddColors()
+{
+    Check check("addColors", addColorsToleranceLsb);
+    for (unsigned one = 0; one < 256; ++one)
+    {
+        for (unsigned two = 0; two < 256; ++two)
+        {
+            Colors::Color_t const sum = Colors::addColors(Colors::Color(one, 0, 0), Colors::Color(two, 0, 0));
+            check.compare(channel(sum, 16), clamp255(one + two));
+        }
+    }
+    return check;
+}
+
+Check checkBlendColors()
+{
+    Check check("blendColors", blendColorsToleranceLsb);
+    for (unsigned one = 0; one < 256; ++one)
+    {
+        for (unsigned two = 0; two < 256; ++two)
+        {
+            for (unsigned alpha = 0; alpha < 256; ++alpha)
+            {
+                Colors::Color_t const blend = Colors::blendColors(Colors::Color(one, 0, 0), Colors::Color(two, 0, 0), alpha);
+                check.compare(channel(blend, 16), one + (static_cast<double>(two) - one) * alpha / 255.);
+            }
+        }
+    }
+    return check;
+}
+
+Check checkColorFromHsv()
+{
+    Check check("colorFromHsv", colorFromHsvToleranceLsb);
+    for (unsigned hue = 0; hue < 256; ++hue)
+    {
+        double const hue6 = hue * 6. / 256.;
+        unsigned const sector = static_cast<unsigned>(hue6);
+        double const fraction = hue6 - sector;
+        for (unsigned saturation = 0; saturation < 256; ++saturation)
+        {
+            double const s = saturation / 255.;
+            for (unsigned value = 0; value < 256; ++value)
+            {
+                double const p = value * (1. - s);
+                double const q = value * (1. - s * fraction);
+                double const t = value * (1. - s * (1. - fraction));
+                double const exact[6][3] = {
+                    {static_cast<double>(value), t, p},
+                    {q, static_cast<double>(value), p},
+                    {p, static_cast<double>(value), t},
+                    {p, q, static_cast<double>(value)},
+                    {t, p, static_cast<double>(value)},
+                    {static_cast<double>(value), p, q},
+                };
+                Colors::Color_t const color = Colors::colorFromHsv(hue, saturation, value);
+                check.compare(channel(color, 16), exact[sector][0]);
+                check.compare(channel(color, 8), exact[sector][1]);
+                check.compare(channel(color, 0), exact[sector][2]);
+            }
+        }
+    }
+    return check;
+}
+
+// The exact weight of a pixel: F(d + .5) - F(d - .5) with d its distance from the hand, wrapped to [-n/2, n/2).
+double exactWeight(ClockFace::SelectableKernel const kernel, double const position, uint16_t const pixel, uint16_t const pixelCount)
+{
+    double distance = pixel - position;
+    distance -= pixelCount * std::floor(distance / pixelCount + .5);
+    ClockFace::SelectableKernelEvaluator const evaluate;
+    return evaluate(kernel, distance + .5) - evaluate(kernel, distance - .5);
+}
+
+enum class Renderer
+{
+    addColorsWrapping,
+    analytic,
+    footprint
+};
+
+void render(Renderer const renderer, Adafruit_NeoPixel & strip, ClockFace::ClockHand const & hand)
+{
+    ClockFace::ClockHand const hands[1] = {hand};
+    switch (renderer)
+    {
+    case Renderer::addColorsWrapping:
+    {
+        strip.clear();
+        ClockFace::SelectableKernelEvaluator const evaluate;
+        auto const kernel = [&](double const x) { return evaluate(hand.kernel, x); };
+        NeoPixelPatterns::addColorsWrapping(strip, hand.position, kernel, hand.color);
+        break;
+    }
+    case Renderer::analytic:
+    {
+        NeoPixelPatterns::renderHands(strip, hands, ClockFace::SelectableKernelEvaluator());
+        break;
+    }
+    case Renderer::footprint:
+    {
+        Footprints::renderHands(strip, hands, ClockFace::SelectableKernelFootprint());
+        break;
+    }
+    }
+}
+
+Check checkRenderer(Renderer const renderer, char const * const name, double const toleranceLsb, RingSweep const & sweep)
+{
+    Check check(std::string(name) + " [" + std::to_string(sweep.pixelCount) + " pixels]", toleranceLsb);
+    Adafruit_NeoPixel strip(sweep.pixelCount);
+    std::vector<double> weights(sweep.pixelCount);
+
+    unsigned const positionCount = sweep.pixelCount * sweep.positionsPerPixel;
+    for (unsigned k = 0; k < ClockFace::selectableKernelCount; ++k)
+    {
+        ClockFace::SelectableKernel const kernel = static_cast<ClockFace::SelectableKernel>(k);
+        for (unsigned p = 0; p < positionCount; ++p)
+        {
+            double const position = static_cast<double>(p) / sweep.positionsPerPixel;
+            for (uint16_t i = 0; i < sweep.pixelCount; ++i)
+            {
+                weights[i] = exactWeight(kernel, position, i, sweep.pixelCount);
+            }
+            for (unsigned brightness = 0; brightness < 256; brightness += sweep.brightnessStep)
+            {
+                // Different values per channel.
+                Colors::Color_t const color = Colors::Color(brightness, 255 - brightness, brightness / 2);
+                render(renderer, strip, ClockFace::ClockHand{position, kernel, color});
+                for (uint16_t i = 0; i < sweep.pixelCount; ++i)
+                {
+                    Colors::Color_t const pixel = strip.getPixelColor(i);
+                    std::string const where = std::string(kernelNames[k]) + " at " + std::to_string(position);
+                    for (uint8_t shift : {16, 8, 0})
+                    {
+                        check.compare(channel(pixel, shift), clamp255(channel(color, shift) * weights[i]), where);
+                    }
+                }
+            }
+        }
+    }
+    return check;
+}
+
+bool runChecks()
+{
+    std::vector<Check> checks;
+    checks.push_back(checkColorScale());
+    checks.push_back(checkColorScaleBrightness());
+    checks.push_back(checkAddColors());
+    checks.push_back(checkBlendColors());
+    checks.push_back(checkColorFromHsv());
+    for (RingSweep const & sweep : ringSweeps)
+    {
+        checks.push_back(checkRenderer(Renderer::addColorsWrapping, "addColorsWrapping", analyticToleranceLsb, sweep));
+        checks.push_back(checkRenderer(Renderer::analytic, "NeoPixelPatterns::renderHands", analyticToleranceLsb, sweep));
+        checks.push_back(checkRenderer(Renderer::footprint, "Footprints::renderHands", footprintToleranceLsb, sweep));
+    }
+
+    bool passed = true;
+    std::printf("Maximum error against the double precision reference [LSB per channel]:\n");
+    for (Check const & check : checks)
+    {
+        std::printf("  %-46s %6.3f  tolerance %5.2f  %s %s\n", check.name.c_str(), check.maximumErrorLsb, check.toleranceLsb,
+                    check.passed() ? "ok  " : "FAIL", check.worstCase.c_str());
+        passed = passed && check.passed();
+    }
+    return passed;
+}
+
+
+// Results are summed up into sink, so that the compiler cannot drop the work.
+volatile uint32_t sink = 0;
+
+// ns per operation - the minimum of several runs of at least 20 ms each. run() performs operationsPerRun operations.
+template<typename Run>
+double nanosecondsPerOperation(Run const & run, unsigned const operationsPerRun)
+{
+    using Clock = std::chrono::steady_clock;
+    uint64_t runCount = 1;
+    while (true)
+    {
+        auto const start = Clock::now();
+        for (uint64_t r = 0; r < runCount; ++r)
+        {
+            sink = sink + run();
+        }
+        if (std::chrono::duration<double>(Clock::now() - start).count() >= .02)
+        {
+            break;
+        }
+        runCount *= 2;
+    }
+
+    double minimum = 0.;
+    for (unsigned repetition = 0; repetition < 7; ++repetition)
+    {
+        auto const start = Clock::now();
+        for (uint64_t r = 0; r < runCount; ++r)
+        {
+            sink = sink + run();
+        }
+        double const nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (runCount * operationsPerRun);
+        minimum = ((0 == repetition) || (nanoseconds < minimum)) ? nanoseconds : minimum;
+    }
+    return minimum;
+}
+
+void printBenchmark(char const * const name, double const nanoseconds, double const baselineNanoseconds)
+{
+    std::printf("  %-52s %8.1f ns  x%.1f\n", name, nanoseconds, baselineNanoseconds / nanoseconds);
+}
+
+uint32_t pixelSum(Adafruit_NeoPixel const & strip)
+{
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < strip.numPixels(); ++i)
+    {
+        sum += strip.getPixelColor(i);
+    }
+    return sum;
+}
+
+// Hands of the firmware's default settings at frameCount times spread over an hour.
+std::vector<std::vector<ClockFace::ClockHand>> clockFrames(uint16_t const pixelCount, unsigned const frameCount)
+{
+    ClockFace::ColorsSettings colorsSettings;
+    colorsSettings.at(ClockFace::DisplayComponent::hours) = ClockFace::ColorSettings{{168, 255}, 200, ClockFace::SelectableKernel::delta};
+    colorsSettings.at(ClockFace::DisplayComponent::minutes) = ClockFace::ColorSettings{{88, 255}, 200, ClockFace::SelectableKernel::mountainNarrow};
+    colorsSettings.at(ClockFace::DisplayComponent::seconds) = ClockFace::ColorSettings{{0, 255}, 200, ClockFace::SelectableKernel::mountainNarrow};
+
+    std::vector<std::vector<ClockFace::ClockHand>> frames;
+    for (unsigned f = 0; f < frameCount; ++f)
+    {
+        double const secondsOfHour = 3600. * f / frameCount;
+        unsigned const wholeSeconds = static_cast<unsigned>(secondsOfHour);
+        ClockFace::TimeOfDay const timeOfDay(10, wholeSeconds / 60, wholeSeconds % 60);
+        ClockFace::ClockHand hands[ClockFace::clockHandCount];
+        ClockFace::clockHandsFromTimeOfDay(hands, pixelCount, timeOfDay, secondsOfHour - wholeSeconds, colorsSettings);
+        frames.emplace_back(hands, hands + ClockFace::clockHandCount);
+    }
+    return frames;
+}
+
+void runBenchmarks()
+{
+    std::printf("Host timings [ns per operation, minimum of 7 runs, speedup against the first of each group]:\n");
+
+    {
+        std::vector<Colors::Color_t> colors;
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            colors.push_back(Colors::Color(i, 255 - i, i / 2));
+        }
+        double const baseline = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (unsigned i = 0; i < 256; ++i)
+            {
+                sum += Colors::colorScaleBrightness(colors[i], i / 255.);
+            }
+            return sum;
+        }, 256);
+        double const optimized = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (unsigned i = 0; i < 256; ++i)
+            {
+                sum += Colors::colorScale(colors[i], i);
+            }
+            return sum;
+        }, 256);
+        printBenchmark("colorScaleBrightness [double]", baseline, baseline);
+        printBenchmark("colorScale [integer]", optimized, baseline);
+    }
+
+    {
+        double const baseline = nanosecondsPerOperation([]() {
+            uint32_t sum = 0;
+            for (int16_t value = -512; value < 512; ++value)
+            {
+                sum += NeoPixelPatterns::normalizePosition(value, static_cast<int16_t>(12));
+            }
+            return sum;
+        }, 1024);
+        double const optimized = nanosecondsPerOperation([]() {
+            uint32_t sum = 0;
+            for (int16_t value = -512; value < 512; ++value)
+            {
+                sum += RingArithmetic::Ring<12>::normalize(value);
+            }
+            return sum;
+        }, 1024);
+        printBenchmark("normalizePosition<int16_t> [%]", baseline, baseline);
+        printBenchmark("RingArithmetic::Ring<12>::normalize", optimized, baseline);
+    }
+
+    {
+        double const baseline = nanosecondsPerOperation([]() {
+            double sum = 0.;
+            for (int i = 0; i < 1024; ++i)
+            {
+                sum += NeoPixelPatterns::symmetrizePosition(i / 64. - 6., 12.);
+            }
+            return static_cast<uint32_t>(sum);
+        }, 1024);
+        double const optimized = nanosecondsPerOperation([]() {
+            double sum = 0.;
+            for (int i = 0; i < 1024; ++i)
+            {
+                sum += RingArithmetic::symmetrizeOnce(i / 64. - 6., 12.);
+            }
+            return static_cast<uint32_t>(sum);
+        }, 1024);
+        printBenchmark("symmetrizePosition<double> [fmod]", baseline, baseline);
+        printBenchmark("RingArithmetic::symmetrizeOnce<double>", optimized, baseline);
+    }
+
+    for (uint16_t const pixelCount : {12, 60})
+    {
+        unsigned const frameCount = 256;
+        std::vector<std::vector<ClockFace::ClockHand>> const frames = clockFrames(pixelCount, frameCount);
+        Adafruit_NeoPixel strip(pixelCount);
+
+        double const baseline = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (std::vector<ClockFace::ClockHand> const & hands : frames)
+            {
+                strip.clear();
+                ClockFace::SelectableKernelEvaluator const evaluate;
+                for (ClockFace::ClockHand const & hand : hands)
+                {
+                    auto const kernel = [&](double const x) { return evaluate(hand.kernel, x); };
+                    NeoPixelPatterns::addColorsWrapping(strip, hand.position, kernel, hand.color);
+                }
+                sum += pixelSum(strip);
+            }
+            return sum;
+        }, frameCount);
+        double const analytic = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (std::vector<ClockFace::ClockHand> const & hands : frames)
+            {
+                ClockFace::ClockHand const handArray[ClockFace::clockHandCount] = {hands[0], hands[1], hands[2]};
+                NeoPixelPatterns::renderHands(strip, handArray, ClockFace::SelectableKernelEvaluator());
+                sum += pixelSum(strip);
+            }
+            return sum;
+        }, frameCount);
+        double const footprint = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (std::vector<ClockFace::ClockHand> const & hands : frames)
+            {
+                ClockFace::ClockHand const handArray[ClockFace::clockHandCount] = {hands[0], hands[1], hands[2]};
+                Footprints::renderHands(strip, handArray, ClockFace::SelectableKernelFootprint());
+                sum += pixelSum(strip);
+            }
+            return sum;
+        }, frameCount);
+
+        std::string const ring = " [frame, " + std::to_string(pixelCount) + " pixels]";
+        printBenchmark(("3x addColorsWrapping" + ring).c_str(), baseline, baseline);
+        printBenchmark(("NeoPixelPatterns::renderHands" + ring).c_str(), analytic, baseline);
+        printBenchmark(("Footprints::renderHands" + ring).c_str(), footprint, baseline);
+    }
+
+    {
+        // The firmware's path for two chained rings - the hours hand inside, minutes and seconds outside.
+        ClockFace::RingLayout const dualRingLayout{{{0, 12}, {12, 60}}, 2, {0, 1, 1}};
+        ClockFace::ColorsSettings colorsSettings;
+        colorsSettings.at(ClockFace::DisplayComponent::hours).selectableKernel = ClockFace::SelectableKernel::delta;
+        Adafruit_NeoPixel strip(dualRingLayout.pixelCount());
+        unsigned const frameCount = 256;
+        double const compose = nanosecondsPerOperation([&]() {
+            uint32_t sum = 0;
+            for (unsigned f = 0; f < frameCount; ++f)
+            {
+                unsigned const seconds = 3600 * f / frameCount;
+                ClockFace::composeTimeOfDay(strip, dualRingLayout, ClockFace::TimeOfDay(10, seconds / 60, seconds % 60), (f % 16) / 16., colorsSettings);
+                sum += pixelSum(strip);
+            }
+            return sum;
+        }, frameCount);
+        printBenchmark("ClockFace::composeTimeOfDay [frame, 12 + 60 pixels]", compose, compose);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    bool check = false;
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == std::strcmp("--check", argv[i]))
+        {
+            check = true;
+        }
+        else if (0 == std::strcmp("--benchmark", argv[i]))
+        {
+            benchmark = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "patternbench: unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!check && !benchmark)
+    {
+        check = true;
+        benchmark = true;
+    }
+
+    bool passed = true;
+    if (check)
+    {
+        passed = runChecks();
+    }
+    if (benchmark)
+    {
+        runBenchmarks();
+    }
+    return passed ? 0 : 1;
+}
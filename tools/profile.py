@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Maps a PRINT_SERIAL_PROFILE histogram [see Profiler.hpp] to the symbols of the ELF.
+
+The samples of a bucket are distributed to the functions overlapping it in proportion
+to the overlap. Reads the last complete dump from a serial port or a log file.
+    profile.py RingClock.elf COM5
+    profile.py RingClock.elf serial.log
+"""
+
+import argparse
+import collections
+import os
+import subprocess
+
+BAUDRATE = 57600
+
+
+def read_lines(source):
+    if os.path.isfile(source):
+        with open(source, 'r', errors='replace') as log:
+            yield from log
+    else:
+        import serial
+        with serial.Serial(source, BAUDRATE) as port:
+            while True:
+                yield port.readline().decode('ascii', errors='replace')
+
+
+def read_dump(source):
+    # From a log file the last complete dump, from a serial port the next one.
+    is_file = os.path.isfile(source)
+    dump = None
+    complete = None
+    for line in read_lines(source):
+        fields = line.split()
+        if 3 == len(fields) and 'PROFILE' == fields[0]:
+            dump = {'samples': int(fields[1]), 'shift': int(fields[2]), 'buckets': {}}
+        elif dump is not None and 1 == len(fields) and 'END' == fields[0]:
+            complete = dump
+            dump = None
+            if not is_file:
+                break
+        elif dump is not None and 2 == len(fields):
+            dump['buckets'][int(fields[0], 16)] = int(fields[1])
+    if complete is None:
+        raise RuntimeError('no complete profile found')
+    return complete
+
+
+def read_symbols(elf, nm):
+    output = subprocess.run([nm, '--demangle', '--numeric-sort', '--print-size', '--defined-only', elf],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split(maxsplit=3)
+        if 4 == len(fields) and fields[2] in 'tTwW':
+            symbols.append((int(fields[0], 16), int(fields[1], 16), fields[3]))
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf')
+    parser.add_argument('source', help='serial port or log file')
+    parser.add_argument('--nm', default='avr-nm')
+    parser.add_argument('--top', type=int, default=30)
+    args = parser.parse_args()
+
+    dump = read_dump(args.source)
+    symbols = read_symbols(args.elf, args.nm)
+    bucket_size = 1 << dump['shift']
+
+    weights = collections.Counter()
+    for start, count in dump['buckets'].items():
+        end = start + bucket_size
+        attributed = 0
+        for address, size, name in symbols:
+            overlap = min(end, address + size) - max(start, address)
+            if 0 < overlap:
+                weights[name] += count * overlap / bucket_size
+                attributed += overlap
+        if attributed < bucket_size:
+            weights['[unknown]'] += count * (bucket_size - attributed) / bucket_size
+
+    total = sum(dump['buckets'].values())
+    print('{} samples, {} byte buckets'.format(total, bucket_size))
+    for name, weight in weights.most_common(args.top):
+        print('{:6.2f}%  {}'.format(100. * weight / total, name))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <avr/eeprom.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace // anonymous namespace
+{
+
+std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+
+// Erased, like a new ATmega's.
+struct Eeprom
+{
+    Eeprom()
+    {
+        std::memset(bytes, 0xFF, sizeof(bytes));
+    }
+
+    uint8_t bytes[E2END + 1];
+};
+
+Eeprom eeprom;
+
+} // anonymous namespace
+
+HostSerial Serial;
+TwoWire Wire;
+
+volatile uint8_t PINB;
+volatile uint8_t DDRB;
+volatile uint8_t PORTB;
+volatile uint8_t PINC;
+volatile uint8_t DDRC;
+volatile uint8_t PORTC;
+volatile uint8_t PIND;
+volatile uint8_t DDRD;
+volatile uint8_t PORTD;
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+void delay(unsigned long const milliseconds)
+{
+    (void)milliseconds;
+}
+
+void pinMode(uint8_t const pin, uint8_t const mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t const pin, uint8_t const value)
+{
+    (void)pin;
+    (void)value;
+}
+
+int digitalRead(uint8_t const pin)
+{
+    (void)pin;
+    return LOW;
+}
+
+void eeprom_read_block(void * const destination, void const * const source, size_t const size)
+{
+    std::memcpy(destination, eeprom.bytes + reinterpret_cast<uintptr_t>(source), size);
+}
+
+void eeprom_update_block(void const * const source, void * const destination, size_t const size)
+{
+    std::memcpy(eeprom.bytes + reinterpret_cast<uintptr_t>(destination), source, size);
+}
+
+void eeprom_write_block(void const * const source, void * const destination, size_t const size)
+{
+    std::memcpy(eeprom.bytes + reinterpret_cast<uintptr_t>(destination), source, size);
+}
@@ -0,0 +1,187 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host replacement of the parts of the Arduino core used by the firmware in replay builds: Serial is
+// a pair of byte queues the replay fills and drains, millis() and micros() run on the host's clock.
+
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+#define DEC 10
+#define HEX 16
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LOW 0x0
+#define HIGH 0x1
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long milliseconds);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+class Print
+{
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t value) = 0;
+
+    size_t write(uint8_t const * const buffer, size_t const size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            write(buffer[i]);
+        }
+        return size;
+    }
+
+    size_t print(char const * const text)
+    {
+        return writeText(text);
+    }
+
+    size_t print(char const character)
+    {
+        return write(static_cast<uint8_t>(character));
+    }
+
+    size_t print(unsigned long const value, int const base = DEC)
+    {
+        return writeText(format(value, base));
+    }
+
+    size_t print(long const value, int const base = DEC)
+    {
+        return (0 > value) ? (write('-') + print(static_cast<unsigned long>(-value), base)) : print(static_cast<unsigned long>(value), base);
+    }
+
+    size_t print(unsigned int const value, int const base = DEC)
+    {
+        return print(static_cast<unsigned long>(value), base);
+    }
+
+    size_t print(int const value, int const base = DEC)
+    {
+        return print(static_cast<long>(value), base);
+    }
+
+    size_t print(unsigned char const value, int const base = DEC)
+    {
+        return print(static_cast<unsigned long>(value), base);
+    }
+
+    size_t print(double const value, int const digits = 2)
+    {
+        std::string text(32, '\0');
+        text.resize(snprintf(&text[0], text.size(), "%.*f", digits, value));
+        return writeText(text);
+    }
+
+    template<typename T>
+    size_t println(T const value)
+    {
+        return print(value) + println();
+    }
+
+    template<typename T>
+    size_t println(T const value, int const baseOrDigits)
+    {
+        return print(value, baseOrDigits) + println();
+    }
+
+    size_t println()
+    {
+        return writeText("\r\n");
+    }
+
+private:
+    size_t writeText(std::string const & text)
+    {
+        return write(reinterpret_cast<uint8_t const *>(text.data()), text.size());
+    }
+
+    static std::string format(unsigned long value, int const base)
+    {
+        std::string digits;
+        do
+        {
+            digits.insert(digits.begin(), "0123456789ABCDEF"[value % base]);
+            value /= base;
+        } while (0 != value);
+        return digits;
+    }
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+};
+
+// Serial: input the firmware reads, output it writes.
+class HostSerial : public Stream
+{
+public:
+    void begin(unsigned long const baudrate)
+    {
+        (void)baudrate;
+    }
+
+    void flush()
+    {
+        // intentionally empty
+    }
+
+    int available() override
+    {
+        return static_cast<int>(input.size());
+    }
+
+    int read() override
+    {
+        if (input.empty())
+        {
+            return -1;
+        }
+        uint8_t const value = input.front();
+        input.pop_front();
+        return value;
+    }
+
+    using Print::write;
+
+    size_t write(uint8_t const value) override
+    {
+        output.push_back(value);
+        return 1;
+    }
+
+    std::deque<uint8_t> input;
+    std::vector<uint8_t> output;
+};
+
+extern HostSerial Serial;
+
+void setup();
+void loop();
+
+#endif // ARDUINO_H
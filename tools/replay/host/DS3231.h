@@ -0,0 +1,55 @@
+#ifndef DS3231_H
+#define DS3231_H
+
+// Host replacement of the DS3231 library: an RTC in 24h mode whose time only changes when it is set.
+// Replay builds read the time from the trace, the firmware only sets it.
+
+#include <Arduino.h>
+
+class DS3231
+{
+public:
+    uint8_t getHour(bool & h12Flag, bool & pmFlag)
+    {
+        h12Flag = false;
+        pmFlag = false;
+        return hours;
+    }
+
+    uint8_t getMinute()
+    {
+        return minutes;
+    }
+
+    uint8_t getSecond()
+    {
+        return seconds;
+    }
+
+    void setClockMode(bool const h12)
+    {
+        (void)h12;
+    }
+
+    void setHour(uint8_t const hours)
+    {
+        this->hours = hours;
+    }
+
+    void setMinute(uint8_t const minutes)
+    {
+        this->minutes = minutes;
+    }
+
+    void setSecond(uint8_t const seconds)
+    {
+        this->seconds = seconds;
+    }
+
+private:
+    uint8_t hours = 0;
+    uint8_t minutes = 0;
+    uint8_t seconds = 0;
+};
+
+#endif // DS3231_H
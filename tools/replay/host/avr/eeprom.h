@@ -0,0 +1,15 @@
+#ifndef AVR_EEPROM_H
+#define AVR_EEPROM_H
+
+// Host replacement - an erased EEPROM [all 0xFF] in RAM, so the firmware starts with its defaults.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <avr/io.h>
+
+void eeprom_read_block(void * destination, void const * source, size_t size);
+void eeprom_update_block(void const * source, void * destination, size_t size);
+void eeprom_write_block(void const * source, void * destination, size_t size);
+
+#endif // AVR_EEPROM_H
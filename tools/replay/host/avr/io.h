@@ -0,0 +1,22 @@
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+// Host replacement - the ATmega328P's port registers as plain variables and the memory sizes.
+
+#include <stdint.h>
+
+extern volatile uint8_t PINB;
+extern volatile uint8_t DDRB;
+extern volatile uint8_t PORTB;
+extern volatile uint8_t PINC;
+extern volatile uint8_t DDRC;
+extern volatile uint8_t PORTC;
+extern volatile uint8_t PIND;
+extern volatile uint8_t DDRD;
+extern volatile uint8_t PORTD;
+
+#define _BV(bit) (1 << (bit))
+
+#define E2END 0x3FF
+
+#endif // AVR_IO_H
@@ -0,0 +1,112 @@
+// Replays a trace [see Trace.hpp, recorded by tools/trace.py record] on the host: the firmware's own
+// RingClock.cpp, built with TRACE_REPLAY, runs its state machine and compose path frame by frame on the
+// recorded inputs. The output has the format of tools/trace.py replay, so host and device replays of a
+// trace can be compared directly - except for micros, which is the host's time per frame.
+//
+// Usage: replay TRACE [CSV]    [default CSV: stdout]
+//   CSV: one line per frame - frame, shown [0/1], micros, pixels as hex [in wire order]
+
+#include <Arduino.h>
+
+#include "Trace.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+[[noreturn]] void fail(std::string const & message)
+{
+    std::cerr << "replay: " << message << std::endl;
+    std::exit(1);
+}
+
+// Takes count bytes from what the firmware wrote.
+std::vector<uint8_t> takeOutput(size_t const count)
+{
+    if (Serial.output.size() < count)
+    {
+        fail("the firmware answered a frame with " + std::to_string(Serial.output.size()) + " bytes");
+    }
+    std::vector<uint8_t> const bytes(Serial.output.begin(), Serial.output.begin() + count);
+    Serial.output.erase(Serial.output.begin(), Serial.output.begin() + count);
+    return bytes;
+}
+
+uint16_t uint16At(std::vector<uint8_t> const & bytes, size_t const offset)
+{
+    return static_cast<uint16_t>(bytes[offset] | (bytes[offset + 1] << 8));
+}
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    if ((2 != argc) && (3 != argc))
+    {
+        fail("usage: replay TRACE [CSV]");
+    }
+
+    std::ifstream trace(argv[1], std::ios::binary);
+    if (!trace)
+    {
+        fail(std::string("cannot open ") + argv[1]);
+    }
+    std::vector<uint8_t> const records((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+    if (0 != records.size() % sizeof(Trace::Record))
+    {
+        fail("truncated trace");
+    }
+
+    std::ofstream file;
+    if (3 == argc)
+    {
+        file.open(argv[2]);
+        if (!file)
+        {
+            fail(std::string("cannot create ") + argv[2]);
+        }
+    }
+    std::ostream & csv = (3 == argc) ? file : std::cout;
+
+    setup();
+    std::vector<uint8_t> const header = takeOutput(5);
+    if ((std::string(header.begin(), header.begin() + 4) != "RCTP") || (Trace::version != header[4]))
+    {
+        fail("the firmware did not start a replay");
+    }
+
+    csv << "frame,shown,micros,pixels\n";
+    size_t const frameCount = records.size() / sizeof(Trace::Record);
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        // The player reads the record in loop() - it never has to wait.
+        Serial.input.insert(Serial.input.end(), records.begin() + frame * sizeof(Trace::Record), records.begin() + (frame + 1) * sizeof(Trace::Record));
+        loop();
+
+        std::vector<uint8_t> const answer = takeOutput(6);
+        if ('F' != answer[0])
+        {
+            fail("lost frame synchronization in frame " + std::to_string(frame));
+        }
+        std::vector<uint8_t> const pixels = takeOutput(uint16At(answer, 4));
+
+        csv << frame << "," << static_cast<unsigned>(answer[1]) << "," << uint16At(answer, 2) << ",";
+        char hex[3];
+        for (uint8_t const byte : pixels)
+        {
+            std::snprintf(hex, sizeof(hex), "%02x", byte);
+            csv << hex;
+        }
+        csv << "\n";
+    }
+
+    std::cerr << "Replayed " << frameCount << " frames." << std::endl;
+    return 0;
+}
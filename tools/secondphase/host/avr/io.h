@@ -0,0 +1,23 @@
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+// Host replacement - the registers SubsecondCounter uses as plain variables [defined by main.cpp].
+
+#include <stdint.h>
+
+extern volatile uint8_t DDRD;
+extern volatile uint8_t PORTD;
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+extern volatile uint8_t TIMSK1;
+extern volatile uint16_t TCNT1;
+
+#define DDD5 5
+#define PORTD5 5
+#define CS10 0
+#define CS11 1
+#define CS12 2
+
+#define _BV(bit) (1 << (bit))
+
+#endif // AVR_IO_H
@@ -0,0 +1,9 @@
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+// Host replacement - there are no interrupts, the block runs once.
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_BLOCK(type) for (bool atomicBlockOnce = true; atomicBlockOnce; atomicBlockOnce = false)
+
+#endif // UTIL_ATOMIC_H
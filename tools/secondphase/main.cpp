@@ -0,0 +1,318 @@
+// Host test of SubsecondCounter::SecondPhase - a simulated DS3231 whose second boundary lies at a known
+// phase of the simulated Timer1 count, read at jittered frame intervals like StateClockDisplay does.
+//
+//     secondphase
+//
+// Checks that the phase is 0 until a second has been seen to advance, that it converges to the RTC's
+// within tolerance - also while the 16 bit count wraps during a read - that it never runs backwards
+// within a second, and that it recovers when the RTC is set [boundary moved, seconds going backwards
+// or skipped].
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <avr/io.h>
+
+#include "SubsecondCounter.hpp"
+
+volatile uint8_t DDRD;
+volatile uint8_t PORTD;
+volatile uint8_t TCCR1A;
+volatile uint8_t TCCR1B;
+volatile uint8_t TIMSK1;
+volatile uint16_t TCNT1;
+
+namespace // anonymous namespace
+{
+
+using SubsecondCounter::countsPerSecond;
+
+// Duration of reading the time over I2C [about 0.5 ms].
+uint32_t constexpr readCounts = 16;
+// Nominal frame interval [20 ms] and its jitter.
+uint32_t constexpr frameCounts = 655;
+uint32_t constexpr frameJitterCounts = 200;
+// After this many seconds of reads the phase has to be within tolerance: the boundary may fall into
+// a read whose latch still sees the previous second [phase held at its end], plus what remains of the window.
+uint32_t constexpr convergenceSeconds = 120;
+uint32_t constexpr toleranceCounts = 2 * readCounts;
+
+// [0, countsPerSecond) -> [-countsPerSecond/2, countsPerSecond/2)
+int32_t symmetrize(int64_t const counts)
+{
+    int64_t const phase = ((counts % countsPerSecond) + countsPerSecond) % countsPerSecond;
+    return static_cast<int32_t>((countsPerSecond / 2 > phase) ? phase : (phase - countsPerSecond));
+}
+
+struct Check
+{
+    std::string name;
+    bool passed = true;
+    int32_t maximumErrorCounts = 0;
+    uint32_t reads = 0;
+
+    explicit Check(std::string const & name)
+        : name(name)
+    {
+        // intentionally empty
+    }
+
+    void fail(char const * const what, uint64_t const time)
+    {
+        if (passed)
+        {
+            std::printf("%s: %s at count %llu\n", name.c_str(), what, static_cast<unsigned long long>(time));
+        }
+        passed = false;
+    }
+
+    void report() const
+    {
+        std::printf("%-40s %s  max error %3d counts [%6.1f us] over %u reads\n",
+                    name.c_str(), passed ? "pass" : "FAIL",
+                    static_cast<int>(maximumErrorCounts), 1e6 * maximumErrorCounts / countsPerSecond,
+                    static_cast<unsigned>(reads));
+    }
+};
+
+// The RTC's seconds advance whenever time [in counts] passes boundary modulo countsPerSecond;
+// Timer1 holds the low 16 bits of time.
+struct Simulation
+{
+    uint64_t time;
+    int64_t boundary;
+    // Added to the seconds the RTC reports - changed when the RTC is set.
+    int64_t secondsOffset = 0;
+
+    std::mt19937 random;
+
+    SubsecondCounter::SecondPhase secondPhase;
+    uint8_t previousSeconds = 60; // invalid, as in SettingsClockDisplay
+    uint16_t previousPhase = 0;
+
+    Simulation(uint64_t const startTime, int64_t const boundary, uint32_t const seed)
+        : time(startTime)
+        , boundary(boundary)
+        , random(seed)
+    {
+        secondPhase.reset();
+    }
+
+    uint8_t rtcSeconds(uint64_t const at) const
+    {
+        int64_t const seconds = (static_cast<int64_t>(at) - boundary) / static_cast<int64_t>(countsPerSecond) + secondsOffset;
+        return static_cast<uint8_t>(((seconds % 60) + 60) % 60);
+    }
+
+    // Counts since the RTC's last second boundary at time.
+    uint16_t truePhase(uint64_t const at) const
+    {
+        return static_cast<uint16_t>(((static_cast<int64_t>(at) - boundary) % countsPerSecond + countsPerSecond) % countsPerSecond);
+    }
+
+    // One frame's RTC read like StateClockDisplay's, then the wait for the next frame.
+    void read(Check & check, bool const converged, uint32_t const intervalCounts = frameCounts)
+    {
+        TCNT1 = static_cast<uint16_t>(time);
+        uint16_t const countBeforeRead = SubsecondCounter::count();
+        // The DS3231 latches its registers at some point during the transfer.
+        uint8_t const seconds = rtcSeconds(time + random() % (readCounts + 1));
+        time += readCounts;
+        TCNT1 = static_cast<uint16_t>(time);
+        uint16_t const countAfterRead = SubsecondCounter::count();
+
+        bool const secondChanged = (previousSeconds != seconds);
+        bool const secondAdvanced = (60 != previousSeconds) && ((previousSeconds + 1) % 60 == seconds);
+        previousSeconds = seconds;
+
+        uint16_t const phase = secondPhase.update(countBeforeRead, countAfterRead, secondChanged, secondAdvanced);
+        ++check.reads;
+
+        if (countsPerSecond <= phase)
+        {
+            check.fail("phase out of range", time);
+        }
+        if (secondChanged && (countsPerSecond / 2 <= phase))
+        {
+            check.fail("phase late in the second right after it changed", time);
+        }
+        if (!secondChanged && (phase < previousPhase))
+        {
+            check.fail("phase ran backwards within a second", time);
+        }
+        previousPhase = phase;
+
+        if (converged)
+        {
+            int32_t const error = symmetrize(static_cast<int64_t>(phase) - truePhase(time));
+            int32_t const absoluteError = (0 > error) ? -error : error;
+            if (check.maximumErrorCounts < absoluteError)
+            {
+                check.maximumErrorCounts = absoluteError;
+            }
+            if (static_cast<int32_t>(toleranceCounts) < absoluteError)
+            {
+                check.fail("phase off by more than the tolerance", time);
+            }
+        }
+
+        time += intervalCounts - frameJitterCounts / 2 + random() % (frameJitterCounts + 1);
+    }
+
+    // Reads for the given number of seconds [in counts].
+    void run(Check & check, uint64_t const counts, bool const converged)
+    {
+        uint64_t const end = time + counts;
+        while (time < end)
+        {
+            read(check, converged);
+        }
+    }
+
+    void converge(Check & check)
+    {
+        run(check, uint64_t(convergenceSeconds) * countsPerSecond, false);
+    }
+};
+
+// Phase 0 until the seconds have been seen to advance once - the first change may be the initial read.
+Check checkUnknownPhase()
+{
+    Check check("phase is 0 until a second advanced");
+    Simulation simulation(1000, 12345, 1);
+    while (simulation.rtcSeconds(simulation.time) == simulation.rtcSeconds(simulation.time + 2 * countsPerSecond - frameCounts))
+    {
+        simulation.time += frameCounts;
+    }
+    uint8_t const firstSeconds = simulation.rtcSeconds(simulation.time);
+    while (simulation.rtcSeconds(simulation.time) != static_cast<uint8_t>((firstSeconds + 1) % 60))
+    {
+        uint16_t const before = static_cast<uint16_t>(simulation.time);
+        uint16_t const phase = simulation.secondPhase.update(before, before + readCounts,
+                                                             simulation.previousSeconds != firstSeconds, false);
+        simulation.previousSeconds = firstSeconds;
+        ++check.reads;
+        if (0 != phase)
+        {
+            check.fail("phase known before the seconds advanced", simulation.time);
+        }
+        simulation.time += frameCounts;
+    }
+    return check;
+}
+
+// Boundaries all around the second, the count starting just before its 16 bit wrap.
+Check checkConvergence(int64_t const boundary, uint64_t const startTime, uint32_t const seed)
+{
+    Check check("boundary " + std::to_string(boundary) + " from count " + std::to_string(startTime));
+    Simulation simulation(startTime, boundary, seed);
+    simulation.converge(check);
+    simulation.run(check, 60ull * countsPerSecond, true);
+    return check;
+}
+
+// Reads that straddle the wrap of the 16 bit count - countAfterRead below countBeforeRead.
+Check checkWrapDuringRead()
+{
+    Check check("count wrapping during reads");
+    Simulation simulation(0, 20000, 2);
+    simulation.converge(check);
+    for (uint32_t wrap = 0; wrap < 100; ++wrap)
+    {
+        // Next read starts a few counts before the wrap.
+        uint64_t const nextWrap = (simulation.time | 0xFFFFull) + 1;
+        simulation.run(check, nextWrap - readCounts / 2 - simulation.time - frameCounts, true);
+        simulation.time = nextWrap - readCounts / 2;
+        simulation.read(check, true);
+    }
+    return check;
+}
+
+// The RTC set by less than a second - the new window does not intersect the learned one.
+Check checkBoundaryMoved(int64_t const shift)
+{
+    Check check("boundary moved by " + std::to_string(shift) + " counts");
+    Simulation simulation(65000, 5000, 3);
+    simulation.converge(check);
+    simulation.boundary += shift;
+    simulation.converge(check);
+    simulation.run(check, 60ull * countsPerSecond, true);
+    return check;
+}
+
+// The RTC set to an earlier or a later second. A change by one looks like an advance in the middle of
+// the second - its window does not intersect the learned one, the next real advance replaces it.
+// Other changes are secondChanged without secondAdvanced and forget the phase right away.
+Check checkSecondsSet(int64_t const secondsOffset)
+{
+    Check check("seconds set by " + std::to_string(secondsOffset));
+    Simulation simulation(30000, 31000, 4);
+    simulation.converge(check);
+    simulation.secondsOffset += secondsOffset;
+    simulation.read(check, false);
+    if ((1 != secondsOffset) && (0 != simulation.previousPhase))
+    {
+        check.fail("phase kept after the seconds jumped", simulation.time);
+    }
+    simulation.converge(check);
+    simulation.run(check, 60ull * countsPerSecond, true);
+    return check;
+}
+
+// Frames further apart than a second [e.g. while the settings are shown] - the seconds skip, which
+// cannot be told from setting the RTC, so the phase is forgotten and learned again.
+Check checkSkippedSeconds()
+{
+    Check check("reads more than a second apart");
+    Simulation simulation(100, 777, 5);
+    simulation.converge(check);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        simulation.time += 2 * countsPerSecond;
+        simulation.read(check, false);
+        if (0 != simulation.previousPhase)
+        {
+            check.fail("phase kept over skipped seconds", simulation.time);
+        }
+    }
+    simulation.converge(check);
+    simulation.run(check, 60ull * countsPerSecond, true);
+    return check;
+}
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    if (1 < argc)
+    {
+        std::fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    Check checks[] = {
+        checkUnknownPhase(),
+        checkConvergence(0, 0, 10),
+        checkConvergence(1, 65536 - 3 * frameCounts, 11),
+        checkConvergence(countsPerSecond / 2, 65536 - 1, 12),
+        checkConvergence(countsPerSecond - 1, 65536 - readCounts / 2, 13),
+        checkConvergence(countsPerSecond + 100, 3 * 65536 - 7, 14),
+        checkWrapDuringRead(),
+        checkBoundaryMoved(300),
+        checkBoundaryMoved(-300),
+        checkBoundaryMoved(countsPerSecond / 2),
+        checkSecondsSet(-5),
+        checkSecondsSet(1),
+        checkSkippedSeconds(),
+    };
+
+    bool passed = true;
+    for (Check const & check : checks)
+    {
+        check.report();
+        passed = passed && check.passed;
+    }
+    return passed ? 0 : 1;
+}
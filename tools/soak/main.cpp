@@ -0,0 +1,60 @@
+// Soak run on the host: the firmware's own RingClock.cpp, built with SOAK_RUN, runs loop() after loop()
+// on its simulated RTC and millis() - the state machine, the subseconds, the compose path and the frame
+// scheduler as on the device, days of clock time in seconds. Per rendered frame the firmware checks the
+// render time against its budget and the hands it shows for backward steps [see Soak.hpp,
+// SoakPositions.hpp]. The render times are the host's.
+//
+// Usage: soak
+//   Prints the firmware's hourly reports and exits with 1 unless the run finishes with PASS.
+//   The duration is set when building [SOAK_DAYS].
+
+#include <Arduino.h>
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+std::string const finishedPrefix = "Soak run finished: ";
+
+} // anonymous namespace
+
+int main(int argc, char ** argv)
+{
+    if (1 < argc)
+    {
+        std::cerr << "usage: " << argv[0] << std::endl;
+        return 1;
+    }
+
+    // The buttons are active low with pull-ups - all released.
+    PINB = 0xFF;
+    PIND = 0xFF;
+
+    setup();
+
+    std::string line;
+    while (true)
+    {
+        loop();
+
+        for (uint8_t const byte : Serial.output)
+        {
+            if ('\n' == byte)
+            {
+                std::cout << line << std::endl;
+                if (0 == line.compare(0, finishedPrefix.size(), finishedPrefix))
+                {
+                    return ("PASS" == line.substr(finishedPrefix.size())) ? 0 : 1;
+                }
+                line.clear();
+            }
+            else if ('\r' != byte)
+            {
+                line += static_cast<char>(byte);
+            }
+        }
+        Serial.output.clear();
+    }
+}
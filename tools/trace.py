@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Host side of the record/replay trace [see Trace.hpp].
+
+record: store the trace of a TRACE_RECORD build to a file.
+    trace.py record COM5 session.trace
+
+replay: feed a trace to a TRACE_REPLAY build and write one CSV line per frame
+        [frame, shown, micros, pixels as hex].
+    trace.py replay COM5 session.trace frames.csv
+
+The same replay runs without a clock on the host [tools/replay, micros there is host time]:
+    replay session.trace frames.csv
+"""
+
+import argparse
+import struct
+import sys
+
+import serial
+
+VERSION = 1
+RECORD_SIZE = 7
+BAUDRATE = 57600
+
+
+def read_exactly(port, count):
+    data = port.read(count)
+    if len(data) != count:
+        raise RuntimeError('timeout - expected {} bytes, got {}'.format(count, len(data)))
+    return data
+
+
+def wait_for_header(port, magic):
+    # The reset caused by opening the port may leave garbage in front of the header.
+    window = b''
+    while True:
+        window = (window + read_exactly(port, 1))[-len(magic):]
+        if window == magic:
+            break
+    version = read_exactly(port, 1)[0]
+    if VERSION != version:
+        raise RuntimeError('unsupported trace version {}'.format(version))
+
+
+def record(args):
+    with serial.Serial(args.port, BAUDRATE, timeout=5) as port, open(args.trace, 'wb') as trace:
+        wait_for_header(port, b'RCTR')
+        frames = 0
+        try:
+            while True:
+                trace.write(read_exactly(port, RECORD_SIZE))
+                frames += 1
+        except KeyboardInterrupt:
+            pass
+        print('recorded {} frames'.format(frames), file=sys.stderr)
+
+
+def replay(args):
+    with open(args.trace, 'rb') as trace:
+        records = trace.read()
+    if 0 != len(records) % RECORD_SIZE:
+        raise RuntimeError('truncated trace')
+
+    with serial.Serial(args.port, BAUDRATE, timeout=5) as port, open(args.csv, 'w') as csv:
+        wait_for_header(port, b'RCTP')
+        csv.write('frame,shown,micros,pixels\n')
+        for frame, offset in enumerate(range(0, len(records), RECORD_SIZE)):
+            port.write(records[offset:offset + RECORD_SIZE])
+            if b'F' != read_exactly(port, 1):
+                raise RuntimeError('lost frame synchronization in frame {}'.format(frame))
+            shown, micros, byte_count = struct.unpack('<BHH', read_exactly(port, 5))
+            pixels = read_exactly(port, byte_count)
+            csv.write('{},{},{},{}\n'.format(frame, shown, micros, pixels.hex()))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    parser_record = commands.add_parser('record')
+    parser_record.add_argument('port')
+    parser_record.add_argument('trace')
+    parser_record.set_defaults(function=record)
+
+    parser_replay = commands.add_parser('replay')
+    parser_replay.add_argument('port')
+    parser_replay.add_argument('trace')
+    parser_replay.add_argument('csv')
+    parser_replay.set_defaults(function=replay)
+
+    args = parser.parse_args()
+    args.function(args)
+
+
+if __name__ == '__main__':
+    main()